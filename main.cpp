@@ -7,20 +7,54 @@
 #include <string>
 #include <iomanip>
 #include <set>
+#include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <cctype>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <cstdlib>
+#include <cstdint>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAVE_X86_SIMD 1
+#endif
 using namespace std;
 
-const int MAX = 1000;
 const float INF = 1e9;
+const double EARTH_RADIUS_KM = 6371.0;
+
+// Registry id of a health center. Ids are arbitrary non-negative 64-bit
+// values; the graph structures use dense node numbers instead (see nodeOf).
+using CenterId = int64_t;
 
 // Structure for a health center (node)
 struct HealthCenter {
-    int id;
+    CenterId id;
     string name;
     string district;
     float lat, lon;
     int capacity;
+    int node = -1; // Dense node number, assigned by internNode
     string toCSV() const {
         return to_string(id) + "," + name + "," + district + "," + to_string(lat) + "," + to_string(lon) + "," + to_string(capacity);
     }
@@ -34,542 +68,6554 @@ struct Connection {
     int to;
     float distance;
     int time;
-    string description; // Added for connection description
+    int descId; // Index into connectionDescriptions
+    int twin;   // Position of the reverse half-edge in adjList[to]
+};
+
+// Contiguous array that either owns its elements or views memory owned
+// elsewhere, such as a memory-mapped snapshot. assign and resize always switch
+// to owned storage, and the first mutable access to a view copies it into owned
+// storage so writes never reach the mapping.
+template <class T>
+class FlatArray {
+public:
+    FlatArray() = default;
+    FlatArray(const FlatArray& other) { *this = other; }
+    FlatArray& operator=(const FlatArray& other) {
+        if (this == &other) return *this;
+        owned = other.owned;
+        if (other.ptr == other.owned.data()) attachOwned();
+        else view(other.ptr, other.count);
+        return *this;
+    }
+
+    void assign(size_t n, const T& value) {
+        owned.assign(n, value);
+        attachOwned();
+    }
+    void resize(size_t n) {
+        detach();
+        owned.resize(n);
+        attachOwned();
+    }
+    void view(const T* data, size_t n) {
+        vector<T>().swap(owned);
+        ptr = data;
+        count = n;
+    }
+
+    T& operator[](size_t i) {
+        detach();
+        return owned[i];
+    }
+    const T& operator[](size_t i) const { return ptr[i]; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    const T* data() const { return ptr; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + count; }
+
+private:
+    void attachOwned() {
+        ptr = owned.data();
+        count = owned.size();
+    }
+    void detach() {
+        if (ptr == owned.data()) return;
+        owned.assign(ptr, ptr + count);
+        attachOwned();
+    }
+
+    vector<T> owned;
+    const T* ptr = nullptr;
+    size_t count = 0;
+};
+
+// Compressed sparse row (CSR) form of the network used by the graph algorithms.
+// The neighbors of node u are targets[offsets[u]] .. targets[offsets[u + 1] - 1],
+// with the matching distances and times in weights and times. Descriptions stay
+// in a side table so edge scans only touch the arrays they need.
+struct CSRGraph {
+    FlatArray<int> offsets;
+    FlatArray<int> targets;
+    FlatArray<float> weights;
+    FlatArray<int> times;
+    FlatArray<int> descIds;
+    // Per-node coordinates for goal-directed search. heuristicScale is chosen
+    // so that heuristicScale * great-circle distance never exceeds the road
+    // distance of any edge, which keeps the A* heuristic consistent.
+    FlatArray<float> lat, lon;
+    float heuristicScale = 0;
+
+    int numNodes() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+    int numEdges() const { return (int)targets.size(); }
+    int degree(int u) const { return offsets[u + 1] - offsets[u]; }
+};
+
+// Fixed set of worker threads shared by the parallel algorithms. parallelFor
+// hands out indices [0, count) dynamically and blocks until all are done; jobs
+// must not call parallelFor themselves.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads) {
+        for (unsigned w = 0; w < max(1u, threads); ++w) workers.emplace_back(&ThreadPool::workerLoop, this, w);
+    }
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        wakeCv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // Runs fn(index, workerId) for every index; workerId is in [0, size()).
+    void parallelFor(size_t count, const function<void(size_t, unsigned)>& fn) {
+        if (count == 0) return;
+        lock_guard<mutex> serial(jobMutex);
+        unique_lock<mutex> lock(m);
+        job = &fn;
+        total = count;
+        next = 0;
+        pending = (unsigned)workers.size();
+        ++generation;
+        wakeCv.notify_all();
+        doneCv.wait(lock, [this] { return pending == 0; });
+        job = nullptr;
+    }
+
+private:
+    void workerLoop(unsigned worker) {
+        unsigned long long seen = 0;
+        while (true) {
+            const function<void(size_t, unsigned)>* fn;
+            size_t count;
+            {
+                unique_lock<mutex> lock(m);
+                wakeCv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+                count = total;
+            }
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) (*fn)(i, worker);
+            lock_guard<mutex> lock(m);
+            if (--pending == 0) doneCv.notify_one();
+        }
+    }
+
+    vector<thread> workers;
+    mutex m, jobMutex;
+    condition_variable wakeCv, doneCv;
+    const function<void(size_t, unsigned)>* job = nullptr;
+    size_t total = 0;
+    atomic<size_t> next{0};
+    unsigned pending = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
+
+ThreadPool& workerPool() {
+    static ThreadPool pool(max(1u, thread::hardware_concurrency()));
+    return pool;
+}
+
+// Row-major n x n distance matrix held in a single 64-byte aligned buffer.
+// Rows are padded to a multiple of the tile size so every tile is full.
+class DistanceMatrix {
+public:
+    DistanceMatrix() = default;
+    ~DistanceMatrix() { release(); }
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+
+    void reset(int size, int tile, float fill) {
+        release();
+        n = size;
+        stride = max(tile, (size + tile - 1) / tile * tile);
+        size_t bytes = (size_t)stride * stride * sizeof(float);
+#ifdef _WIN32
+        data = (float*)_aligned_malloc(bytes, 64);
+#else
+        data = (float*)aligned_alloc(64, bytes);
+#endif
+        if (!data) throw bad_alloc();
+        fill_n(data, (size_t)stride * stride, fill);
+    }
+
+    int size() const { return n; }
+    int rowStride() const { return stride; }
+    float* row(int i) { return data + (size_t)i * stride; }
+    float at(int i, int j) const { return data[(size_t)i * stride + j]; }
+
+private:
+    void release() {
+#ifdef _WIN32
+        _aligned_free(data);
+#else
+        free(data);
+#endif
+        data = nullptr;
+        n = stride = 0;
+    }
+
+    float* data = nullptr;
+    int n = 0, stride = 0;
 };
 
 // Global data structures
 vector<HealthCenter> centers;
-vector<Connection> adjList[MAX];
-vector<vector<float>> fwDistances; // For Floyd-Warshall
+vector<vector<Connection>> adjList; // Editable adjacency lists, indexed by node
+vector<string> connectionDescriptions; // Side table for connection descriptions
+vector<int> descriptionRefs; // Connections using each description
+vector<int> freeDescriptions; // Description slots no connection uses, reused first
+CSRGraph network; // Read-only snapshot of adjList used by the algorithms
+bool networkDirty = true;
+bool adjacencyPending = false; // adjList not yet rebuilt from a loaded snapshot
+long long networkVersion = 0; // Bumped on every CSR rebuild
+DistanceMatrix fwDistances; // For Floyd-Warshall, indexed by fwNodes position
+vector<int> fwNodes; // Dense Floyd-Warshall index -> node
 
 // Utility function for numeric validation
 bool isNumber(const string& s) {
     return !s.empty() && all_of(s.begin(), s.end(), ::isdigit);
 }
 
-// File I/O Functions
-void createHealthCentersFile(const string& filename) {
-    ofstream file(filename);
-    file << "ID,Name,District,Latitude,Longitude,Capacity\n";
-    file.close();
+// Great-circle distance between two coordinates in kilometres.
+float haversineKm(float lat1, float lon1, float lat2, float lon2) {
+    const double toRad = M_PI / 180.0;
+    double dLat = (lat2 - lat1) * toRad;
+    double dLon = (lon2 - lon1) * toRad;
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * toRad) * cos(lat2 * toRad) * sin(dLon / 2) * sin(dLon / 2);
+    return (float)(2 * EARTH_RADIUS_KM * asin(min(1.0, sqrt(a))));
 }
 
-void createConnectionsFile(const string& filename) {
-    ofstream file(filename);
-    file << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
-    file.close();
+// Graph storage helpers
+void materializeAdjacency();
+
+// Must run before adjList or connectionDescriptions are read or changed.
+void ensureAdjacency() {
+    if (adjacencyPending) materializeAdjacency();
 }
 
-bool fileExists(const string& filename) {
-    ifstream file(filename);
-    return file.good();
+// Center ids and dense nodes
+// Every array over the network is indexed by node, not by center id, so its
+// size follows the number of centers rather than the largest id. nodeIndex
+// maps an id to its node and nodeIds maps back (-1 marks a free node).
+// Nodes released by removals are reused before new ones are added.
+unordered_map<CenterId, int> nodeIndex;
+vector<CenterId> nodeIds;
+vector<int> freeNodes;
+
+// Node of id, or -1 if the id is unknown.
+int nodeOf(CenterId id) {
+    auto it = nodeIndex.find(id);
+    return it == nodeIndex.end() ? -1 : it->second;
 }
 
-void readHealthCenters(const string& filename) {
-    if (!fileExists(filename)) {
-        cout << filename << " does not exist. Creating new file.\n";
-        createHealthCentersFile(filename);
-        return;
+CenterId idOf(int node) {
+    return nodeIds[node];
+}
+
+// Node of id, assigning one (and an empty adjacency list) if the id is new.
+int internNode(CenterId id) {
+    ensureAdjacency();
+    auto [it, inserted] = nodeIndex.try_emplace(id, (int)nodeIds.size());
+    if (!inserted) return it->second;
+    if (!freeNodes.empty()) {
+        it->second = freeNodes.back();
+        freeNodes.pop_back();
+        nodeIds[it->second] = id;
+    } else {
+        nodeIds.push_back(id);
+        adjList.resize(nodeIds.size());
     }
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cout << "Error opening " << filename << endl;
-        return;
+    networkDirty = true;
+    return it->second;
+}
+
+// Returns the node of a removed center to the free list. Its connections
+// must already be gone.
+void releaseNode(int node) {
+    nodeIndex.erase(nodeIds[node]);
+    nodeIds[node] = -1;
+    freeNodes.push_back(node);
+}
+
+void clearNodes() {
+    nodeIndex.clear();
+    nodeIds.clear();
+    freeNodes.clear();
+}
+
+// Position of each node's record in centers, -1 for nodes without one.
+// Rebuilt on first use after a bulk load; single adds and removals keep it
+// current, removals by moving the last record into the freed position.
+vector<int> centerSlots;
+bool centerSlotsStale = true;
+
+void refreshCenterSlots() {
+    if (!centerSlotsStale) return;
+    centerSlots.assign(nodeIds.size(), -1);
+    for (int i = 0; i < (int)centers.size(); ++i) centerSlots[centers[i].node] = i;
+    centerSlotsStale = false;
+}
+
+// Whether node holds a center record; connections may name ids that have
+// none. Only reads centerSlots, so it is safe on pool workers once
+// refreshCenterSlots has run.
+bool hasCenterRecord(int node) {
+    return node < (int)centerSlots.size() && centerSlots[node] >= 0;
+}
+
+HealthCenter* findCenter(CenterId id) {
+    refreshCenterSlots();
+    int node = nodeOf(id);
+    if (node < 0 || node >= (int)centerSlots.size() || centerSlots[node] < 0) return nullptr;
+    return &centers[centerSlots[node]];
+}
+
+// Descriptions are reference counted by connection, since generated networks
+// share one description across many roads. A slot whose last connection is
+// removed is emptied and handed to the next new description.
+int addDescription(const string& desc) {
+    if (!freeDescriptions.empty()) {
+        int descId = freeDescriptions.back();
+        freeDescriptions.pop_back();
+        connectionDescriptions[descId] = desc;
+        return descId;
     }
-    string line;
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        HealthCenter hc;
-        string temp;
-        try {
-            getline(ss, temp, ','); hc.id = stoi(temp);
-            getline(ss, hc.name, ',');
-            getline(ss, hc.district, ',');
-            getline(ss, temp, ','); hc.lat = stof(temp);
-            getline(ss, temp, ','); hc.lon = stof(temp);
-            getline(ss, temp, ','); hc.capacity = stoi(temp);
-            centers.push_back(hc);
-        } catch (const invalid_argument& e) {
-            cout << "Skipping invalid line in " << filename << ": " << line << endl;
-            continue;
-        } catch (const out_of_range& e) {
-            cout << "Skipping out-of-range values in " << filename << ": " << line << endl;
-            continue;
+    connectionDescriptions.push_back(desc);
+    descriptionRefs.push_back(0);
+    return (int)connectionDescriptions.size() - 1;
+}
+
+void releaseDescription(int descId) {
+    if (--descriptionRefs[descId] > 0) return;
+    string().swap(connectionDescriptions[descId]);
+    freeDescriptions.push_back(descId);
+}
+
+void clearDescriptions() {
+    connectionDescriptions.clear();
+    descriptionRefs.clear();
+    freeDescriptions.clear();
+}
+
+// Union-find over nodes with union by size and path halving.
+struct DisjointSets {
+    vector<int> parent;
+    vector<int> size;
+
+    void reset(int n) {
+        parent.clear();
+        size.clear();
+        grow(n);
+    }
+    // Adds singleton sets until there are n.
+    void grow(int n) {
+        for (int i = parent.size(); i < n; ++i) {
+            parent.push_back(i);
+            size.push_back(1);
         }
     }
-    file.close();
+    int find(int x) {
+        while (parent[x] != x) {
+            parent[x] = parent[parent[x]];
+            x = parent[x];
+        }
+        return x;
+    }
+    // Root lookup without compression, safe for concurrent readers.
+    int root(int x) const {
+        while (parent[x] != x) x = parent[x];
+        return x;
+    }
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (size[a] < size[b]) swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+        return true;
+    }
+};
+
+// Connected components of the network, kept current by every inserted
+// connection through a union-find. Removing a connection or center can split
+// a component, which a union-find cannot undo, so removals only mark the
+// index stale and the next query rebuilds it in one pass over the graph.
+// cycleEdges counts connections that joined two already-connected centers;
+// the network has a cycle exactly when it is non-zero.
+struct ConnectivityIndex {
+    DisjointSets sets;
+    long long cycleEdges = 0;
+    bool stale = true;
+
+    // Records a new connection; returns true if it closed a cycle.
+    bool add(int from, int to) {
+        sets.grow(max(from, to) + 1);
+        bool closesCycle = !sets.unite(from, to);
+        if (closesCycle) ++cycleEdges;
+        return closesCycle;
+    }
+};
+
+ConnectivityIndex connectivity;
+
+// Half-edges
+// Each connection is stored as two half-edges, one in each endpoint's list,
+// that record each other's position. Removal swaps the last half-edge of a
+// list into the freed slot and repoints that half-edge's twin, so deleting a
+// connection costs O(1) once it is found and deleting a center costs
+// O(degree). List order is therefore not stable across removals.
+void linkHalfEdges(int from, int to, float distance, int time, int descId) {
+    int fromSlot = adjList[from].size();
+    int toSlot = from == to ? fromSlot + 1 : (int)adjList[to].size();
+    adjList[from].push_back({to, distance, time, descId, toSlot});
+    adjList[to].push_back({from, distance, time, descId, fromSlot}); // Undirected
+    ++descriptionRefs[descId];
 }
 
-void readConnections(const string& filename) {
-    if (!fileExists(filename)) {
-        cout << filename << " does not exist. Creating new file.\n";
-        createConnectionsFile(filename);
-        return;
+// Position of a half-edge from u to v in adjList[u], or -1.
+int findHalfEdge(int u, int v) {
+    const vector<Connection>& list = adjList[u];
+    for (int slot = 0; slot < (int)list.size(); ++slot) {
+        if (list[slot].to == v) return slot;
     }
-    ifstream file(filename);
-    if (!file.is_open()) {
-        cout << "Error opening " << filename << endl;
-        return;
+    return -1;
+}
+
+// Positions in adjList[u] of every connection between u and v, counting each
+// self-loop once.
+vector<int> connectionSlots(int u, int v) {
+    vector<int> slots;
+    const vector<Connection>& list = adjList[u];
+    for (int slot = 0; slot < (int)list.size(); ++slot) {
+        if (list[slot].to == v && (u != v || slot < list[slot].twin)) slots.push_back(slot);
     }
-    string line;
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        int from, to, time;
-        float distance;
-        string desc, temp;
-        try {
-            getline(ss, temp, ','); from = stoi(temp);
-            getline(ss, temp, ','); to = stoi(temp);
-            getline(ss, temp, ','); distance = stof(temp);
-            getline(ss, temp, ','); time = stoi(temp);
-            getline(ss, desc); // Read description
-            adjList[from].push_back({to, distance, time, desc});
-            adjList[to].push_back({from, distance, time, desc}); // Undirected
-        } catch (const invalid_argument& e) {
-            cout << "Skipping invalid line in " << filename << ": " << line << endl;
-            continue;
-        } catch (const out_of_range& e) {
-            cout << "Skipping out-of-range values in " << filename << ": " << line << endl;
-            continue;
+    return slots;
+}
+
+void popHalfEdge(int u, int slot) {
+    vector<Connection>& list = adjList[u];
+    if (slot + 1 < (int)list.size()) {
+        list[slot] = list.back();
+        adjList[list[slot].to][list[slot].twin].twin = slot;
+    }
+    list.pop_back();
+}
+
+// Removes the connection whose half-edge is adjList[u][slot]. A self-loop
+// has both halves in one list; the higher slot goes first so the lower one
+// is not moved.
+void eraseConnectionAt(int u, int slot) {
+    int v = adjList[u][slot].to, twin = adjList[u][slot].twin;
+    releaseDescription(adjList[u][slot].descId);
+    if (u == v) {
+        popHalfEdge(u, max(slot, twin));
+        popHalfEdge(u, min(slot, twin));
+    } else {
+        popHalfEdge(v, twin);
+        popHalfEdge(u, slot);
+    }
+    connectivity.stale = true;
+    networkDirty = true;
+}
+
+// Removes every connection between from and to; returns how many there were.
+int removeConnections(int from, int to) {
+    int removed = 0;
+    for (int slot = 0; slot < (int)adjList[from].size();) {
+        if (adjList[from][slot].to == to) {
+            eraseConnectionAt(from, slot);
+            ++removed;
+        } else {
+            ++slot;
         }
     }
-    file.close();
+    return removed;
 }
 
-void saveHealthCenters(const string& filename) {
-    ofstream file(filename);
-    file << "ID,Name,District,Latitude,Longitude,Capacity\n";
+// Removes every connection of node.
+void isolateNode(int node) {
+    while (!adjList[node].empty()) eraseConnectionAt(node, (int)adjList[node].size() - 1);
+}
+
+void insertConnection(int from, int to, float distance, int time, const string& desc) {
+    ensureAdjacency();
+    linkHalfEdges(from, to, distance, time, addDescription(desc));
+    if (!connectivity.stale) connectivity.add(from, to);
+    networkDirty = true;
+}
+
+// Sets both halves of the connection at adjList[u][slot]. A description
+// shared with other connections is copied rather than changed for all of them.
+void updateConnectionAt(int u, int slot, float distance, int time, const string& desc) {
+    Connection& c = adjList[u][slot];
+    Connection& back = adjList[c.to][c.twin];
+    c.distance = back.distance = distance;
+    c.time = back.time = time;
+    if (descriptionRefs[c.descId] > 1) {
+        releaseDescription(c.descId);
+        c.descId = back.descId = addDescription(desc);
+        ++descriptionRefs[c.descId];
+    } else {
+        connectionDescriptions[c.descId] = desc;
+    }
+    networkDirty = true;
+}
+
+// Rebuilds the CSR arrays from the editable adjacency lists with a counting pass.
+void buildNetwork() {
+    ensureAdjacency();
+    int n = (int)adjList.size();
+
+    network.offsets.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u) network.offsets[u + 1] = network.offsets[u] + (int)adjList[u].size();
+    int m = network.offsets[n];
+    network.targets.resize(m);
+    network.weights.resize(m);
+    network.times.resize(m);
+    network.descIds.resize(m);
+    for (int u = 0; u < n; ++u) {
+        int e = network.offsets[u];
+        for (const auto& c : adjList[u]) {
+            network.targets[e] = c.to;
+            network.weights[e] = c.distance;
+            network.times[e] = c.time;
+            network.descIds[e] = c.descId;
+            ++e;
+        }
+    }
+
+    // Coordinates for A*. Nodes without a health center record have no
+    // position, so any edge touching one disables the heuristic.
+    network.lat.assign(n, 0);
+    network.lon.assign(n, 0);
+    vector<bool> located(n, false);
     for (const auto& hc : centers) {
-        file << hc.id << "," << hc.name << "," << hc.district << ","
-             << fixed << setprecision(4) << hc.lat << "," << hc.lon << "," << hc.capacity << "\n";
+        network.lat[hc.node] = hc.lat;
+        network.lon[hc.node] = hc.lon;
+        located[hc.node] = true;
     }
-    file.close();
+    float scale = 1.0f;
+    for (int u = 0; u < n && scale > 0; ++u) {
+        for (int e = network.offsets[u]; e < network.offsets[u + 1]; ++e) {
+            int v = network.targets[e];
+            if (!located[u] || !located[v]) {
+                scale = 0;
+                break;
+            }
+            float straight = haversineKm(network.lat[u], network.lon[u], network.lat[v], network.lon[v]);
+            if (straight > 0) scale = min(scale, network.weights[e] / straight);
+        }
+    }
+    network.heuristicScale = scale * 0.999f; // Margin for float rounding
+    networkDirty = false;
+    ++networkVersion;
+}
+
+const CSRGraph& graph() {
+    if (networkDirty) buildNetwork();
+    return network;
+}
+
+// Node of id for a query, or -1 if the id is not in the network.
+int queryNode(CenterId id) {
+    int node = nodeOf(id);
+    return node >= 0 && node < graph().numNodes() ? node : -1;
+}
+
+// Rebuilds the connectivity index from the CSR graph when an edit left it
+// stale. Each connection is seen from both ends; only the lower end counts
+// it, and a self-loop's two half-edges count once.
+ConnectivityIndex& connectivityIndex() {
+    if (!connectivity.stale) {
+        connectivity.sets.grow(adjList.size());
+        return connectivity;
+    }
+    const CSRGraph& g = graph();
+    connectivity.sets.reset(g.numNodes());
+    connectivity.cycleEdges = 0;
+    connectivity.stale = false;
+    long long selfLoopHalves = 0;
+    for (int u = 0; u < g.numNodes(); ++u) {
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            if (v == u) ++selfLoopHalves;
+            else if (u < v) connectivity.add(u, v);
+        }
+    }
+    connectivity.cycleEdges += selfLoopHalves / 2;
+    return connectivity;
+}
+
+bool connected(int a, int b) {
+    DisjointSets& sets = connectivityIndex().sets;
+    return sets.find(a) == sets.find(b);
+}
+
+// Nearest capable center index
+// For a capacity threshold, a layer records for every node its nearest center
+// with capacity >= threshold (its Voronoi owner), the distance to it and the
+// next hop towards it. A layer is built on the first emergency query for its
+// threshold with one multi-source Dijkstra and afterwards patched locally when
+// centers or connections change. Repairs scan adjList because they run
+// between edits, while the CSR snapshot is stale.
+struct CapacityLayer {
+    vector<float> dist;
+    vector<int> owner;   // -1 when no qualifying center is reachable
+    vector<int> nextHop; // -1 at the owner itself
+    vector<int> pending; // Nodes cleared by detach, waiting for repairLayers
+};
+
+map<int, CapacityLayer> capacityLayers; // Keyed by minimum capacity
+
+void growLayer(CapacityLayer& layer) {
+    size_t n = adjList.size();
+    if (layer.dist.size() < n) {
+        layer.dist.resize(n, INF);
+        layer.owner.resize(n, -1);
+        layer.nextHop.resize(n, -1);
+    }
+}
+
+// Priority queues for the shortest-path searches. Each offers reset(n),
+// push(node, key) to insert or lower a key, empty() and pop(), which returns
+// the smallest (key, node). Queues without decrease-key may return stale
+// entries whose key is above the node's current distance; callers skip them.
+
+// Binary heap with lazy deletion: lowering a key pushes a second entry.
+struct LazyBinaryHeap {
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> heap;
+
+    void reset(int) { heap = {}; }
+    bool empty() const { return heap.empty(); }
+    void push(int v, float key) { heap.push({key, v}); }
+    pair<float, int> pop() {
+        pair<float, int> top = heap.top();
+        heap.pop();
+        return top;
+    }
+};
+
+// Indexed D-ary heap with real decrease-key, so the heap never holds more
+// than one entry per node. pos[v] is v's slot, -1 when v is not queued.
+template <int D>
+struct IndexedDaryHeap {
+    vector<pair<float, int>> heap;
+    vector<int> pos;
+
+    void reset(int n) {
+        // Only nodes still queued by a search that stopped early need clearing.
+        if ((int)pos.size() != n) pos.assign(n, -1);
+        else for (const auto& item : heap) pos[item.second] = -1;
+        heap.clear();
+    }
+    bool empty() const { return heap.empty(); }
+    void push(int v, float key) {
+        int i = pos[v];
+        if (i < 0) {
+            i = heap.size();
+            heap.push_back({key, v});
+        } else if (key < heap[i].first) {
+            heap[i].first = key;
+        } else {
+            return;
+        }
+        siftUp(i);
+    }
+    pair<float, int> pop() {
+        pair<float, int> top = heap[0];
+        pos[top.second] = -1;
+        pair<float, int> last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            siftDown(0);
+        }
+        return top;
+    }
+
+private:
+    void place(int i, const pair<float, int>& item) {
+        heap[i] = item;
+        pos[item.second] = i;
+    }
+    void siftUp(int i) {
+        pair<float, int> item = heap[i];
+        while (i > 0 && item.first < heap[(i - 1) / D].first) {
+            place(i, heap[(i - 1) / D]);
+            i = (i - 1) / D;
+        }
+        place(i, item);
+    }
+    void siftDown(int i) {
+        pair<float, int> item = heap[i];
+        int n = heap.size();
+        while (true) {
+            int first = i * D + 1;
+            if (first >= n) break;
+            int best = first;
+            for (int c = first + 1; c < min(first + D, n); ++c) {
+                if (heap[c].first < heap[best].first) best = c;
+            }
+            if (!(heap[best].first < item.first)) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, item);
+    }
+};
+
+using QuaternaryHeap = IndexedDaryHeap<4>;
+
+uint32_t floatBits(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof bits);
+    return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+    float f;
+    memcpy(&f, &bits, sizeof f);
+    return f;
+}
+
+// Number of bits needed to hold x (0 for 0).
+int bitWidth(uint32_t x) {
+#if defined(__GNUC__)
+    return x ? 32 - __builtin_clz(x) : 0;
+#else
+    int width = 0;
+    for (; x; x >>= 1) ++width;
+    return width;
+#endif
+}
+
+// Index of the lowest set bit of a non-zero x.
+int trailingZeros(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int zeros = 0;
+    for (; !(x & 1); x >>= 1) ++zeros;
+    return zeros;
+#endif
+}
+
+// Monotone radix heap. Keys must never drop below the last key popped, which
+// holds for Dijkstra with non-negative weights. Non-negative floats order the
+// same way as their bit patterns, so the pattern serves as an exact integer
+// key without scaling. Bucket b holds keys whose highest bit differing from
+// the last popped key is bit b - 1; lowering a key leaves a stale entry.
+struct RadixHeap {
+    vector<pair<uint32_t, int>> buckets[33];
+    uint32_t last = 0;
+    size_t count = 0;
+
+    void reset(int) {
+        for (auto& b : buckets) b.clear();
+        last = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    void push(int v, float key) {
+        uint32_t bits = floatBits(key);
+        buckets[bitWidth(bits ^ last)].push_back({bits, v});
+        ++count;
+    }
+    pair<float, int> pop() {
+        if (buckets[0].empty()) {
+            int b = 1;
+            while (buckets[b].empty()) ++b;
+            last = min_element(buckets[b].begin(), buckets[b].end())->first;
+            for (const auto& item : buckets[b]) buckets[bitWidth(item.first ^ last)].push_back(item);
+            buckets[b].clear();
+        }
+        pair<uint32_t, int> top = buckets[0].back();
+        buckets[0].pop_back();
+        --count;
+        return {bitsFloat(top.first), top.second};
+    }
+};
+
+// Queue used by dijkstra and the emergency layers; override with
+// -DSHORTEST_PATH_QUEUE=LazyBinaryHeap or QuaternaryHeap. `--bench queues`
+// compares the three on every generated network shape.
+#ifndef SHORTEST_PATH_QUEUE
+#define SHORTEST_PATH_QUEUE RadixHeap
+#endif
+using ShortestPathQueue = SHORTEST_PATH_QUEUE;
+
+// Dijkstra outward from seeds whose labels were just lowered.
+void propagateLayer(CapacityLayer& layer, const vector<int>& seeds) {
+    ShortestPathQueue pq;
+    pq.reset(layer.dist.size());
+    for (int s : seeds) pq.push(s, layer.dist[s]);
+    while (!pq.empty()) {
+        auto [d, u] = pq.pop();
+        if (d > layer.dist[u]) continue;
+        for (const auto& c : adjList[u]) {
+            if (d + c.distance < layer.dist[c.to]) {
+                layer.dist[c.to] = d + c.distance;
+                layer.owner[c.to] = layer.owner[u];
+                layer.nextHop[c.to] = u;
+                pq.push(c.to, layer.dist[c.to]);
+            }
+        }
+    }
+}
+
+CapacityLayer& capacityLayer(int minCapacity) {
+    ensureAdjacency();
+    auto it = capacityLayers.find(minCapacity);
+    if (it != capacityLayers.end()) {
+        growLayer(it->second);
+        return it->second;
+    }
+    CapacityLayer& layer = capacityLayers[minCapacity];
+    growLayer(layer);
+    vector<int> sources;
+    for (const auto& hc : centers) {
+        if (hc.capacity >= minCapacity) {
+            layer.dist[hc.node] = 0;
+            layer.owner[hc.node] = hc.node;
+            sources.push_back(hc.node);
+        }
+    }
+    propagateLayer(layer, sources);
+    return layer;
+}
+
+// Clears root and every node whose path to its owner runs through it. Must be
+// called while the edges that define the current paths are still in place.
+// Owners are set to -2 to mark cleared nodes until repairLayers runs.
+void detachSubtree(CapacityLayer& layer, int root) {
+    if ((size_t)root >= layer.dist.size() || layer.owner[root] == -2) return;
+    size_t first = layer.pending.size();
+    layer.pending.push_back(root);
+    layer.owner[root] = -2;
+    for (size_t i = first; i < layer.pending.size(); ++i) {
+        int x = layer.pending[i];
+        for (const auto& c : adjList[x]) {
+            if (layer.nextHop[c.to] == x && layer.owner[c.to] != -2) {
+                layer.owner[c.to] = -2;
+                layer.pending.push_back(c.to);
+            }
+        }
+        layer.dist[x] = INF;
+        layer.nextHop[x] = -1;
+    }
+}
+
+// Relabels the nodes cleared by detachSubtree from their surviving neighbours.
+// Qualifying centers never sit inside a detached subtree (they have no next
+// hop), so every cleared node is reached through its neighbours.
+void repairLayers() {
+    for (auto& entry : capacityLayers) {
+        CapacityLayer& layer = entry.second;
+        if (layer.pending.empty()) continue;
+        growLayer(layer);
+        vector<int> seeds;
+        for (int x : layer.pending) {
+            for (const auto& c : adjList[x]) {
+                int y = c.to;
+                if (layer.owner[y] >= 0 && layer.dist[y] + c.distance < layer.dist[x]) {
+                    layer.dist[x] = layer.dist[y] + c.distance;
+                    layer.nextHop[x] = y;
+                    layer.owner[x] = layer.owner[y];
+                }
+            }
+        }
+        for (int x : layer.pending) {
+            if (layer.owner[x] == -2) layer.owner[x] = -1;
+            else seeds.push_back(x);
+        }
+        layer.pending.clear();
+        propagateLayer(layer, seeds);
+    }
+}
+
+void detachConnectionFromLayers(int from, int to) {
+    for (auto& entry : capacityLayers) {
+        CapacityLayer& layer = entry.second;
+        if ((size_t)max(from, to) >= layer.dist.size()) continue;
+        if (layer.nextHop[from] == to) detachSubtree(layer, from);
+        else if (layer.nextHop[to] == from) detachSubtree(layer, to);
+    }
+}
+
+void detachCenterFromLayers(int node) {
+    for (auto& entry : capacityLayers) detachSubtree(entry.second, node);
+}
+
+// Lets a new or shortened connection pull each endpoint closer to an owner.
+void relaxLayersAcross(int from, int to) {
+    for (auto& entry : capacityLayers) {
+        CapacityLayer& layer = entry.second;
+        growLayer(layer);
+        vector<int> seeds;
+        for (int u : {from, to}) {
+            for (const auto& c : adjList[u]) {
+                int v = c.to;
+                if ((v == from || v == to) && layer.owner[u] >= 0 && layer.dist[u] + c.distance < layer.dist[v]) {
+                    layer.dist[v] = layer.dist[u] + c.distance;
+                    layer.owner[v] = layer.owner[u];
+                    layer.nextHop[v] = u;
+                    seeds.push_back(v);
+                }
+            }
+        }
+        propagateLayer(layer, seeds);
+    }
+}
+
+// Makes the center at node an owner in every layer its capacity now
+// qualifies for, and withdraws it from layers it no longer qualifies for.
+void updateCenterInLayers(int node, int oldCapacity, int newCapacity) {
+    for (auto& entry : capacityLayers) {
+        if (oldCapacity >= entry.first && newCapacity < entry.first) detachSubtree(entry.second, node);
+    }
+    repairLayers();
+    for (auto& entry : capacityLayers) {
+        CapacityLayer& layer = entry.second;
+        if (newCapacity < entry.first || oldCapacity >= entry.first) continue;
+        growLayer(layer);
+        layer.dist[node] = 0;
+        layer.owner[node] = node;
+        layer.nextHop[node] = -1;
+        propagateLayer(layer, {node});
+    }
+}
+
+// Spatial index over center coordinates
+// Centers are bucketed into a uniform lat/lon grid held in a hash map, so
+// empty areas cost nothing. The cell size is chosen on each full rebuild for
+// about two centers per cell; adds, edits and removals then move single
+// entries. Positions are kept per node so an entry can be found again after
+// its center's coordinates change.
+const double KM_PER_DEGREE = EARTH_RADIUS_KM * M_PI / 180.0;
+
+struct CenterGrid {
+    double cellDeg = 0.05;
+    unordered_map<uint64_t, vector<int>> cells;
+    vector<float> lat, lon;
+    vector<bool> indexed;
+    int count = 0;
+    int minRow = 0, maxRow = -1, minCol = 0, maxCol = -1; // Bounds of every cell used so far
+    bool stale = true;
+
+    int rowOf(float la) const { return (int)floor(la / cellDeg); }
+    int colOf(float lo) const { return (int)floor(lo / cellDeg); }
+    static uint64_t key(int row, int col) { return (uint64_t)(uint32_t)row << 32 | (uint32_t)col; }
+
+    void insert(int node, float la, float lo) {
+        if (node >= (int)indexed.size()) {
+            lat.resize(node + 1);
+            lon.resize(node + 1);
+            indexed.resize(node + 1, false);
+        }
+        if (indexed[node]) erase(node);
+        int row = rowOf(la), col = colOf(lo);
+        cells[key(row, col)].push_back(node);
+        lat[node] = la;
+        lon[node] = lo;
+        indexed[node] = true;
+        ++count;
+        if (minRow > maxRow) {
+            minRow = maxRow = row;
+            minCol = maxCol = col;
+        }
+        minRow = min(minRow, row);
+        maxRow = max(maxRow, row);
+        minCol = min(minCol, col);
+        maxCol = max(maxCol, col);
+    }
+    void erase(int node) {
+        if (node >= (int)indexed.size() || !indexed[node]) return;
+        auto it = cells.find(key(rowOf(lat[node]), colOf(lon[node])));
+        vector<int>& nodes = it->second;
+        nodes.erase(find(nodes.begin(), nodes.end(), node));
+        if (nodes.empty()) cells.erase(it);
+        indexed[node] = false;
+        --count;
+    }
+    template <class Visit>
+    void forCell(int row, int col, Visit visit) const {
+        auto it = cells.find(key(row, col));
+        if (it == cells.end()) return;
+        for (int node : it->second) visit(node);
+    }
+};
+
+CenterGrid centerGrid;
+
+CenterGrid& spatialIndex() {
+    if (!centerGrid.stale) return centerGrid;
+    CenterGrid& grid = centerGrid;
+    grid = CenterGrid();
+    grid.stale = false;
+    if (!centers.empty()) {
+        float loLat = centers[0].lat, hiLat = loLat, loLon = centers[0].lon, hiLon = loLon;
+        for (const auto& hc : centers) {
+            loLat = min(loLat, hc.lat);
+            hiLat = max(hiLat, hc.lat);
+            loLon = min(loLon, hc.lon);
+            hiLon = max(hiLon, hc.lon);
+        }
+        double area = max(1e-6, (double)(hiLat - loLat) * (hiLon - loLon));
+        grid.cellDeg = max(0.001, sqrt(area * 2 / centers.size()));
+    }
+    grid.cells.reserve(centers.size());
+    for (const auto& hc : centers) grid.insert(hc.node, hc.lat, hc.lon);
+    return grid;
+}
+
+// Keeps the index in step with a center edit; a no-op until it is first built.
+void updateCenterInSpatialIndex(int node, const HealthCenter* hc) {
+    if (centerGrid.stale) return;
+    if (hc) centerGrid.insert(node, hc->lat, hc->lon);
+    else centerGrid.erase(node);
+}
+
+// Lower bound in km on the distance from (la, lo) to any point more than
+// `cells` cells away in both directions. Longitude degrees shrink towards the
+// poles, so they are scaled at the highest latitude the band can reach.
+double ringLowerBoundKm(const CenterGrid& grid, float la, int cells) {
+    double band = cells * grid.cellDeg;
+    double maxLat = min(89.9, fabs((double)la) + band + grid.cellDeg);
+    return band * KM_PER_DEGREE * cos(maxLat * M_PI / 180.0) * 0.999;
+}
+
+// The k centers closest to (la, lo) by great-circle distance, as (km, node)
+// pairs nearest first. Rings of cells are searched outward until the k-th
+// best beats everything outside the ring.
+vector<pair<float, int>> nearestCenters(float la, float lo, int k) {
+    const CenterGrid& grid = spatialIndex();
+    vector<pair<float, int>> best; // Max-heap on distance
+    if (k <= 0 || grid.count == 0) return best;
+    int row = grid.rowOf(la), col = grid.colOf(lo);
+    int maxRing = max({row - grid.minRow, grid.maxRow - row, col - grid.minCol, grid.maxCol - col});
+    auto visit = [&](int node) {
+        float d = haversineKm(la, lo, grid.lat[node], grid.lon[node]);
+        if ((int)best.size() < k) {
+            best.push_back({d, node});
+            push_heap(best.begin(), best.end());
+        } else if (make_pair(d, node) < best.front()) {
+            pop_heap(best.begin(), best.end());
+            best.back() = {d, node};
+            push_heap(best.begin(), best.end());
+        }
+    };
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        if (ring == 0) {
+            grid.forCell(row, col, visit);
+        } else {
+            for (int c = col - ring; c <= col + ring; ++c) {
+                grid.forCell(row - ring, c, visit);
+                grid.forCell(row + ring, c, visit);
+            }
+            for (int r = row - ring + 1; r < row + ring; ++r) {
+                grid.forCell(r, col - ring, visit);
+                grid.forCell(r, col + ring, visit);
+            }
+        }
+        if ((int)best.size() == k && best.front().first <= ringLowerBoundKm(grid, la, ring)) break;
+    }
+    sort_heap(best.begin(), best.end());
+    return best;
+}
+
+// Every center within radiusKm of (la, lo), as (km, node) pairs nearest first.
+vector<pair<float, int>> centersWithinRadius(float la, float lo, float radiusKm) {
+    const CenterGrid& grid = spatialIndex();
+    vector<pair<float, int>> found;
+    if (grid.count == 0 || radiusKm < 0) return found;
+    double dLat = radiusKm / KM_PER_DEGREE;
+    double maxLat = min(89.9, fabs((double)la) + dLat);
+    double dLon = min(180.0, dLat / max(1e-3, cos(maxLat * M_PI / 180.0)));
+    int r0 = max(grid.minRow, grid.rowOf(la - dLat)), r1 = min(grid.maxRow, grid.rowOf(la + dLat));
+    int c0 = max(grid.minCol, grid.colOf(lo - dLon)), c1 = min(grid.maxCol, grid.colOf(lo + dLon));
+    auto visit = [&](int node) {
+        float d = haversineKm(la, lo, grid.lat[node], grid.lon[node]);
+        if (d <= radiusKm) found.push_back({d, node});
+    };
+    if ((double)(r1 - r0 + 1) * (c1 - c0 + 1) > grid.cells.size()) {
+        // Window larger than the occupied cells: walk those instead.
+        for (const auto& cell : grid.cells) {
+            for (int node : cell.second) visit(node);
+        }
+    } else {
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) grid.forCell(r, c, visit);
+        }
+    }
+    sort(found.begin(), found.end());
+    return found;
+}
+
+// File I/O Functions
+template <class T>
+void writePod(ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool readPod(istream& in, T& value) {
+    return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+template <class T>
+void writeArray(ostream& out, const vector<T>& values) {
+    writePod(out, (uint64_t)values.size());
+    out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+template <class T>
+bool readArray(istream& in, vector<T>& values) {
+    uint64_t count;
+    if (!readPod(in, count) || count > (1ULL << 34)) return false;
+    values.resize(count);
+    return (bool)in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+}
+
+// FNV-1a hash of the CSR arrays; identifies which network a saved index belongs to.
+uint64_t networkFingerprint(const CSRGraph& g) {
+    uint64_t h = 1469598103934665603ULL;
+    auto mix = [&h](const void* data, size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i) h = (h ^ p[i]) * 1099511628211ULL;
+    };
+    mix(g.offsets.data(), g.offsets.size() * sizeof(int));
+    mix(g.targets.data(), g.targets.size() * sizeof(int));
+    mix(g.weights.data(), g.weights.size() * sizeof(float));
+    return h;
+}
+
+// Read-only view of a whole file: memory-mapped on POSIX systems and read
+// into a heap buffer elsewhere.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& filename) {
+        close();
+#ifndef _WIN32
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                bytes = static_cast<const char*>(p);
+                length = (size_t)st.st_size;
+            }
+        }
+        ::close(fd);
+        return bytes != nullptr;
+#else
+        ifstream in(filename, ios::binary | ios::ate);
+        if (!in) return false;
+        length = (size_t)in.tellg();
+        buffer.resize(length / sizeof(uint64_t) + 1); // 8-byte aligned storage
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), length);
+        bytes = reinterpret_cast<const char*>(buffer.data());
+        return (bool)in;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (bytes) munmap(const_cast<char*>(bytes), length);
+#else
+        vector<uint64_t>().swap(buffer);
+#endif
+        bytes = nullptr;
+        length = 0;
+    }
+
+    void swap(MappedFile& other) {
+        std::swap(bytes, other.bytes);
+        std::swap(length, other.length);
+#ifdef _WIN32
+        buffer.swap(other.buffer);
+#endif
+    }
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    vector<uint64_t> buffer;
+#endif
+};
+
+void createHealthCentersFile(const string& filename) {
+    ofstream file(filename);
+    file << "ID,Name,District,Latitude,Longitude,Capacity\n";
+    file.close();
+}
+
+void createConnectionsFile(const string& filename) {
+    ofstream file(filename);
+    file << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
+    file.close();
+}
+
+bool fileExists(const string& filename) {
+    ifstream file(filename);
+    return file.good();
+}
+
+// CSV ingestion
+// The loaders map the file and walk it in place: lines and fields are found
+// with memchr, numbers are converted with from_chars, and a row that fails to
+// parse is reported with its line number instead of throwing. Files larger
+// than CSV_PARALLEL_BYTES are cut at line boundaries into chunks that are
+// parsed on the worker pool and then merged in file order.
+const size_t CSV_PARALLEL_BYTES = 1 << 20;
+
+struct CsvIssue {
+    size_t line; // 1-based line number in the file
+    string message;
+};
+
+struct CsvFields {
+    const char* pos;
+    const char* end;
+
+    // Next field up to the following comma (or the end of the line).
+    string_view next() {
+        const char* comma = static_cast<const char*>(memchr(pos, ',', end - pos));
+        const char* stop = comma ? comma : end;
+        string_view field(pos, stop - pos);
+        pos = comma ? comma + 1 : end;
+        return field;
+    }
+    // Everything left on the line, commas included.
+    string_view rest() {
+        string_view field(pos, end - pos);
+        pos = end;
+        return field;
+    }
+};
+
+string_view trimField(string_view field) {
+    while (!field.empty() && isspace((unsigned char)field.front())) field.remove_prefix(1);
+    while (!field.empty() && isspace((unsigned char)field.back())) field.remove_suffix(1);
+    return field;
+}
+
+template <class T>
+bool parseNumber(string_view field, T& value) {
+    field = trimField(field);
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    auto result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr == field.data() + field.size() && !field.empty();
+}
+
+struct CsvChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t lines = 0;
+    vector<CsvIssue> issues; // Line numbers relative to the chunk until merged
+};
+
+// Parses every line in chunk with parseRow(fields, rows), which returns
+// nullptr on success or a reason for rejecting the line.
+template <class Row, class ParseRow>
+void parseCsvChunk(CsvChunk& chunk, vector<Row>& rows, const ParseRow& parseRow) {
+    const char* pos = chunk.begin;
+    while (pos < chunk.end) {
+        const char* newline = static_cast<const char*>(memchr(pos, '\n', chunk.end - pos));
+        const char* lineEnd = newline ? newline : chunk.end;
+        const char* contentEnd = lineEnd;
+        if (contentEnd > pos && contentEnd[-1] == '\r') --contentEnd;
+        ++chunk.lines;
+        if (contentEnd > pos) {
+            CsvFields fields = {pos, contentEnd};
+            if (const char* reason = parseRow(fields, rows)) {
+                chunk.issues.push_back({chunk.lines, string(reason) + ": " + string(pos, contentEnd - pos)});
+            }
+        }
+        pos = lineEnd + 1;
+    }
+}
+
+// Parses all data rows of a mapped CSV file (the header line is skipped).
+template <class Row, class ParseRow>
+vector<Row> parseCsvFile(const MappedFile& file, const ParseRow& parseRow, vector<CsvIssue>& issues, bool parallel) {
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+    const char* header = static_cast<const char*>(memchr(begin, '\n', file.size()));
+    const char* data = header ? header + 1 : end;
+
+    size_t parts = 1;
+    if (parallel && (size_t)(end - data) > CSV_PARALLEL_BYTES) parts = workerPool().size() * 4;
+    vector<CsvChunk> chunks;
+    const char* pos = data;
+    for (size_t i = 1; i <= parts && pos < end; ++i) {
+        const char* cut = i == parts ? end : data + (end - data) * i / parts;
+        if (cut < pos) cut = pos;
+        if (cut < end) {
+            const char* newline = static_cast<const char*>(memchr(cut, '\n', end - cut));
+            cut = newline ? newline + 1 : end;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = pos;
+        chunks.back().end = cut;
+        pos = cut;
+    }
+
+    vector<vector<Row>> chunkRows(chunks.size());
+    if (chunks.size() > 1) {
+        workerPool().parallelFor(chunks.size(), [&](size_t i, unsigned) { parseCsvChunk(chunks[i], chunkRows[i], parseRow); });
+    } else if (!chunks.empty()) {
+        parseCsvChunk(chunks[0], chunkRows[0], parseRow);
+    }
+
+    vector<Row> rows;
+    size_t total = 0, line = 1; // Line 1 is the header
+    for (const auto& part : chunkRows) total += part.size();
+    rows.reserve(total);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        for (auto& issue : chunks[i].issues) issues.push_back({line + issue.line, move(issue.message)});
+        line += chunks[i].lines;
+        move(chunkRows[i].begin(), chunkRows[i].end(), back_inserter(rows));
+    }
+    return rows;
+}
+
+void reportCsvIssues(const string& filename, const vector<CsvIssue>& issues) {
+    for (const auto& issue : issues) {
+        cout << "Skipping line " << issue.line << " in " << filename << " (" << issue.message << ")\n";
+    }
+}
+
+// Opens filename for parsing, creating it with create() when it is missing.
+// Returns false when there is nothing to parse.
+bool openCsv(const string& filename, MappedFile& file, void (*create)(const string&)) {
+    if (!fileExists(filename)) {
+        cout << filename << " does not exist. Creating new file.\n";
+        create(filename);
+        return false;
+    }
+    if (!file.open(filename)) {
+        // mmap refuses empty files; anything else is a real error.
+        ifstream probe(filename, ios::ate);
+        if (!probe.is_open() || probe.tellg() > 0) cout << "Error opening " << filename << endl;
+        return false;
+    }
+    return true;
+}
+
+void readHealthCenters(const string& filename, bool parallel = true) {
+    MappedFile file;
+    if (!openCsv(filename, file, createHealthCentersFile)) return;
+    auto parseRow = [](CsvFields& f, vector<HealthCenter>& rows) -> const char* {
+        HealthCenter hc;
+        if (!parseNumber(f.next(), hc.id)) return "invalid ID";
+        if (hc.id < 0) return "negative ID";
+        string_view name = f.next(), district = f.next();
+        if (!parseNumber(f.next(), hc.lat) || !parseNumber(f.next(), hc.lon)) return "invalid coordinates";
+        if (!parseNumber(f.next(), hc.capacity)) return "invalid capacity";
+        hc.name.assign(name);
+        hc.district.assign(district);
+        rows.push_back(move(hc));
+        return nullptr;
+    };
+    vector<CsvIssue> issues;
+    vector<HealthCenter> rows = parseCsvFile<HealthCenter>(file, parseRow, issues, parallel);
+    reportCsvIssues(filename, issues);
+    nodeIndex.reserve(nodeIndex.size() + rows.size());
+    for (auto& hc : rows) hc.node = internNode(hc.id);
+    move(rows.begin(), rows.end(), back_inserter(centers));
+    centerGrid.stale = true;
+    centerSlotsStale = true;
+}
+
+void readConnections(const string& filename, bool parallel = true) {
+    MappedFile file;
+    if (!openCsv(filename, file, createConnectionsFile)) {
+        buildNetwork();
+        return;
+    }
+    struct Row {
+        CenterId from, to;
+        int time;
+        float distance;
+        string_view desc; // Points into the mapped file
+    };
+    auto parseRow = [](CsvFields& f, vector<Row>& rows) -> const char* {
+        Row r;
+        if (!parseNumber(f.next(), r.from) || !parseNumber(f.next(), r.to)) return "invalid ID";
+        if (r.from < 0 || r.to < 0) return "negative ID";
+        if (!parseNumber(f.next(), r.distance)) return "invalid distance";
+        if (!parseNumber(f.next(), r.time)) return "invalid time";
+        // The radix heap and the float-bit radix orders need non-negative keys.
+        if (!(r.distance >= 0)) return "negative distance";
+        if (r.time < 0) return "negative time";
+        r.desc = f.rest();
+        rows.push_back(r);
+        return nullptr;
+    };
+    vector<CsvIssue> issues;
+    vector<Row> rows = parseCsvFile<Row>(file, parseRow, issues, parallel);
+    reportCsvIssues(filename, issues);
+
+    ensureAdjacency();
+    connectivity.stale = true;
+    connectionDescriptions.reserve(connectionDescriptions.size() + rows.size());
+    for (const auto& r : rows) insertConnection(internNode(r.from), internNode(r.to), r.distance, r.time, string(r.desc));
+    buildNetwork();
+}
+
+void writeHealthCentersFile(const string& filename, const vector<HealthCenter>& list) {
+    ofstream file(filename);
+    file << "ID,Name,District,Latitude,Longitude,Capacity\n";
+    for (const auto& hc : list) {
+        file << hc.id << "," << hc.name << "," << hc.district << ","
+             << fixed << setprecision(4) << hc.lat << "," << hc.lon << "," << hc.capacity << "\n";
+    }
+    file.close();
+}
+
+void saveHealthCenters(const string& filename) {
+    writeHealthCentersFile(filename, centers);
+}
+
+// One undirected connection as stored in connections.csv.
+struct ConnectionRow {
+    CenterId from, to;
+    float distance;
+    int time;
+    string description;
+};
+
+// Lists every connection once, from its lower-numbered node. A self-loop has both
+// halves in the same list, so only the one in the lower slot is kept.
+vector<ConnectionRow> connectionRows() {
+    ensureAdjacency();
+    vector<ConnectionRow> rows;
+    for (int i = 0; i < (int)adjList.size(); ++i) {
+        for (int slot = 0; slot < (int)adjList[i].size(); ++slot) {
+            const Connection& c = adjList[i][slot];
+            if (c.to == i && c.twin < slot) continue;
+            if (i <= c.to) rows.push_back({idOf(i), idOf(c.to), c.distance, c.time, connectionDescriptions[c.descId]});
+        }
+    }
+    return rows;
+}
+
+void writeConnectionsFile(const string& filename, const vector<ConnectionRow>& rows) {
+    ofstream file(filename);
+    file << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
+    for (const auto& r : rows) {
+        file << r.from << "," << r.to << "," << fixed << setprecision(2) << r.distance << "," << r.time << "," << r.description << "\n";
+    }
+    file.close();
+}
+
+void saveConnections(const string& filename) {
+    writeConnectionsFile(filename, connectionRows());
+}
+
+// Change journal
+// Edits are appended to network.journal as one-line records instead of
+// rewriting the CSV files:
+//   C,<ID>,<Name>,<District>,<Latitude>,<Longitude>,<Capacity>  add or replace a center
+//   X,<ID>                                                     remove a center
+//   E,<FromID>,<ToID>,<DistanceKM>,<TimeMinutes>,<Description>  add or replace a connection
+//   A,<FromID>,<ToID>,<DistanceKM>,<TimeMinutes>,<Description>  add a parallel connection
+//   R,<FromID>,<ToID>                                          remove every connection between the two
+// Each record sets absolute state, so replaying one twice is harmless. A
+// records only follow an R record for the same pair, and the group as a whole
+// sets the pair's state.
+// Records are buffered and made durable in groups: one write and fsync per
+// JOURNAL_GROUP_RECORDS records or per JOURNAL_COMMIT_MS window. Once enough
+// records pile up the journal is rotated to network.journal.old and a
+// background thread folds the state into the CSV files, then deletes it.
+const char* JOURNAL_FILE = "network.journal";
+const char* OLD_JOURNAL_FILE = "network.journal.old";
+const size_t JOURNAL_GROUP_RECORDS = 64;
+const int JOURNAL_COMMIT_MS = 20;
+const size_t JOURNAL_COMPACT_MIN_RECORDS = 1000;
+
+class ChangeJournal {
+public:
+    ~ChangeJournal() { close(); }
+
+    bool open(const string& filename) {
+        close();
+        path = filename;
+        file = fopen(path.c_str(), "ab");
+        if (!file) return false;
+        writeFailed = false;
+        stopping = false;
+        flusher = thread(&ChangeJournal::flushLoop, this);
+        return true;
+    }
+
+    void close() {
+        if (!file) return;
+        {
+            lock_guard<mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (flusher.joinable()) flusher.join();
+        commit();
+        fclose(file);
+        file = nullptr;
+    }
+
+    void append(const string& record) {
+        if (!file) return;
+        bool full;
+        {
+            lock_guard<mutex> lock(m);
+            pending += record;
+            pending += '\n';
+            ++recordCount;
+            full = ++pendingCount >= JOURNAL_GROUP_RECORDS;
+        }
+        if (full) commit();
+        else cv.notify_one();
+    }
+
+    // Whether appended records still reach the disk. Once a write or a
+    // rotation fails this stays false and callers must refuse edits.
+    bool writable() const { return file && !writeFailed; }
+
+    // Records appended since the journal was opened or last rotated.
+    size_t size() {
+        lock_guard<mutex> lock(m);
+        return recordCount;
+    }
+
+    // Commits pending records, renames the journal to oldName and continues in
+    // a fresh, empty file. Returns false when the journal was not rotated: if
+    // the rename fails, or the fresh file cannot be opened and the rename is
+    // undone, appending continues in the same journal. If no journal can be
+    // reopened at all, writable() turns false.
+    bool rotate(const string& oldName) {
+        lock_guard<mutex> fileLock(fileMutex);
+        writePending();
+        if (!file) return false;
+        fclose(file);
+        file = nullptr;
+        bool rotated = rename(path.c_str(), oldName.c_str()) == 0;
+        if (rotated) file = fopen(path.c_str(), "ab");
+        if (!file) {
+            if (rotated && rename(oldName.c_str(), path.c_str()) == 0) rotated = false;
+            if (!rotated) file = fopen(path.c_str(), "ab");
+        }
+        if (!rotated || !file) return false;
+        lock_guard<mutex> lock(m);
+        recordCount = 0;
+        return true;
+    }
+
+    void commit() {
+        lock_guard<mutex> fileLock(fileMutex);
+        writePending();
+    }
+
+private:
+    // Caller holds fileMutex, which keeps groups in append order.
+    void writePending() {
+        string batch;
+        {
+            lock_guard<mutex> lock(m);
+            batch.swap(pending);
+            pendingCount = 0;
+        }
+        if (batch.empty()) return;
+        if (!file || fwrite(batch.data(), 1, batch.size(), file) != batch.size() || fflush(file) != 0) {
+            writeFailed = true;
+            return;
+        }
+#ifdef _WIN32
+        _commit(_fileno(file));
+#else
+        fsync(fileno(file));
+#endif
+    }
+
+    void flushLoop() {
+        unique_lock<mutex> lock(m);
+        while (!stopping) {
+            cv.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) break;
+            // Give other records of the same burst a chance to join the group.
+            cv.wait_for(lock, chrono::milliseconds(JOURNAL_COMMIT_MS), [this] { return stopping; });
+            lock.unlock();
+            commit();
+            lock.lock();
+        }
+    }
+
+    string path;
+    FILE* file = nullptr;
+    thread flusher;
+    mutex m, fileMutex;
+    condition_variable cv;
+    string pending;
+    size_t pendingCount = 0, recordCount = 0;
+    bool stopping = false;
+    atomic<bool> writeFailed{false};
+};
+
+// Writes the CSV files from a private copy of the network on a background
+// thread, then removes the rotated journal whose records the copy includes.
+class JournalCompactor {
+public:
+    ~JournalCompactor() { wait(); }
+
+    bool busy() const { return running; }
+
+    void start(vector<HealthCenter> centerCopy, vector<ConnectionRow> rowCopy) {
+        wait();
+        running = true;
+        worker = thread([this, c = move(centerCopy), r = move(rowCopy)] {
+            writeHealthCentersFile("health_centers.csv.tmp", c);
+            writeConnectionsFile("connections.csv.tmp", r);
+            rename("health_centers.csv.tmp", "health_centers.csv");
+            rename("connections.csv.tmp", "connections.csv");
+            remove(OLD_JOURNAL_FILE);
+            running = false;
+        });
+    }
+
+    void wait() {
+        if (worker.joinable()) worker.join();
+    }
+
+private:
+    thread worker;
+    atomic<bool> running{false};
+};
+
+ChangeJournal journal;
+JournalCompactor compactor;
+
+// Rotates the journal and starts a background compaction once the journal
+// has grown to a quarter of the network, so each edit costs O(1) I/O on average.
+void maybeCompactJournal() {
+    size_t threshold = max(JOURNAL_COMPACT_MIN_RECORDS, (centers.size() + network.numEdges() / 2) / 4);
+    if (journal.size() < threshold || compactor.busy()) return;
+    if (!journal.rotate(OLD_JOURNAL_FILE)) {
+        cout << "Error: could not rotate " << JOURNAL_FILE << "; compaction skipped.\n";
+        return;
+    }
+    compactor.start(centers, connectionRows());
+}
+
+// Edits are only accepted while they can be journaled; otherwise they would
+// change memory alone and be lost on restart.
+bool journalWritable() {
+    if (journal.writable()) return true;
+    cout << "Error: " << JOURNAL_FILE << " cannot be written; edit refused.\n";
+    return false;
+}
+
+void journalRecord(const string& record) {
+    journal.append(record);
+    maybeCompactJournal();
+}
+
+// Appends records that must be replayed together; the journal is only
+// rotated after the last one.
+void journalRecords(const vector<string>& records) {
+    for (const string& record : records) journal.append(record);
+    maybeCompactJournal();
+}
+
+string formatNumber(double value) {
+    ostringstream out;
+    out << setprecision(9) << value;
+    return out.str();
+}
+
+void journalCenter(const HealthCenter& hc) {
+    journalRecord("C," + to_string(hc.id) + "," + hc.name + "," + hc.district + "," + formatNumber(hc.lat) + "," +
+                  formatNumber(hc.lon) + "," + to_string(hc.capacity));
+}
+
+string connectionRecord(const char* kind, int lo, int hi, const Connection& c) {
+    return string(kind) + "," + to_string(idOf(lo)) + "," + to_string(idOf(hi)) + "," + formatNumber(c.distance) + "," +
+           to_string(c.time) + "," + connectionDescriptions[c.descId];
+}
+
+// Records the connection as connections.csv would store it: from its lower-numbered node.
+void journalConnection(int from, int to) {
+    int lo = min(from, to), hi = max(from, to);
+    int slot = findHalfEdge(lo, hi);
+    if (slot < 0) return;
+    journalRecord(connectionRecord("E", lo, hi, adjList[lo][slot]));
+}
+
+// Records every connection between from and to after one of them changed.
+// An E record would replace whichever parallel connection replay finds
+// first, so parallel connections are journaled as a removal of the pair
+// followed by one A record per connection.
+void journalConnectionPair(int from, int to) {
+    int lo = min(from, to), hi = max(from, to);
+    vector<int> slots = connectionSlots(lo, hi);
+    if (slots.size() <= 1) {
+        journalConnection(lo, hi);
+        return;
+    }
+    vector<string> records = {"R," + to_string(idOf(lo)) + "," + to_string(idOf(hi))};
+    for (int slot : slots) records.push_back(connectionRecord("A", lo, hi, adjList[lo][slot]));
+    journalRecords(records);
+}
+
+// Applies the records of one journal file. Returns the number applied.
+size_t replayJournal(const string& filename) {
+    ifstream file(filename);
+    if (!file.is_open()) return 0;
+    ensureAdjacency();
+    unordered_map<CenterId, size_t> centerIndex;
+    for (size_t i = 0; i < centers.size(); ++i) centerIndex[centers[i].id] = i;
+    vector<bool> removed(centers.size(), false);
+
+    string line;
+    size_t applied = 0;
+    while (getline(file, line)) {
+        stringstream ss(line);
+        string kind, temp;
+        getline(ss, kind, ',');
+        try {
+            if (kind == "C") {
+                HealthCenter hc;
+                getline(ss, temp, ','); hc.id = stoll(temp);
+                getline(ss, hc.name, ',');
+                getline(ss, hc.district, ',');
+                getline(ss, temp, ','); hc.lat = stof(temp);
+                getline(ss, temp, ','); hc.lon = stof(temp);
+                getline(ss, temp, ','); hc.capacity = stoi(temp);
+                if (hc.id < 0) continue;
+                hc.node = internNode(hc.id);
+                auto it = centerIndex.find(hc.id);
+                if (it != centerIndex.end()) {
+                    centers[it->second] = hc;
+                } else {
+                    centerIndex[hc.id] = centers.size();
+                    centers.push_back(hc);
+                    removed.push_back(false);
+                }
+            } else if (kind == "X") {
+                getline(ss, temp, ','); CenterId id = stoll(temp);
+                auto it = centerIndex.find(id);
+                if (it == centerIndex.end()) continue;
+                int node = centers[it->second].node;
+                removed[it->second] = true;
+                centerIndex.erase(it);
+                isolateNode(node);
+                releaseNode(node);
+            } else if (kind == "E" || kind == "A") {
+                CenterId fromId, toId;
+                int time;
+                float distance;
+                string desc;
+                getline(ss, temp, ','); fromId = stoll(temp);
+                getline(ss, temp, ','); toId = stoll(temp);
+                getline(ss, temp, ','); distance = stof(temp);
+                getline(ss, temp, ','); time = stoi(temp);
+                getline(ss, desc);
+                if (fromId < 0 || toId < 0 || !(distance >= 0) || time < 0) continue;
+                int from = internNode(fromId), to = internNode(toId);
+                int slot = kind == "E" ? findHalfEdge(from, to) : -1;
+                if (slot >= 0) updateConnectionAt(from, slot, distance, time, desc);
+                else insertConnection(from, to, distance, time, desc);
+            } else if (kind == "R") {
+                getline(ss, temp, ','); int from = nodeOf(stoll(temp));
+                getline(ss, temp, ','); int to = nodeOf(stoll(temp));
+                if (from < 0 || to < 0) continue;
+                removeConnections(from, to);
+            } else {
+                continue;
+            }
+            ++applied;
+        } catch (const invalid_argument& e) {
+            cout << "Skipping invalid record in " << filename << ": " << line << endl;
+        } catch (const out_of_range& e) {
+            cout << "Skipping out-of-range values in " << filename << ": " << line << endl;
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < centers.size(); ++i) {
+        if (!removed[i]) centers[kept++] = centers[i];
+    }
+    centers.resize(kept);
+    centerGrid.stale = true;
+    centerSlotsStale = true;
+    networkDirty = true;
+    return applied;
+}
+
+// Applies the edits recorded since the CSV files were last written.
+void replayJournals() {
+    size_t applied = replayJournal(OLD_JOURNAL_FILE);
+    applied += replayJournal(JOURNAL_FILE);
+    if (applied) cout << "Replayed " << applied << " journal records.\n";
+}
+
+// Opens the journal for appending, after replayJournals. A leftover rotated
+// journal means a compaction was interrupted, so the CSV files are brought up
+// to date first.
+void openJournal() {
+    if (fileExists(OLD_JOURNAL_FILE)) {
+        saveHealthCenters("health_centers.csv");
+        saveConnections("connections.csv");
+        remove(OLD_JOURNAL_FILE);
+        remove(JOURNAL_FILE);
+    }
+    if (!journal.open(JOURNAL_FILE)) cout << "Error opening " << JOURNAL_FILE << endl;
+}
+
+void closeJournal() {
+    journal.close();
+    compactor.wait();
+}
+
+// CRUD Operations
+void addHealthCenter() {
+    if (!journalWritable()) return;
+    HealthCenter hc;
+    string idStr, capacityStr;
+    cout << "Enter ID: "; cin >> idStr;
+    if (!isNumber(idStr)) {
+        cout << "Error: ID must be a number.\n";
+        return;
+    }
+    try {
+        hc.id = stoll(idStr);
+    } catch (const out_of_range&) {
+        cout << "Error: ID is too large.\n";
+        return;
+    }
+    if (findCenter(hc.id)) {
+        cout << "ID already exists!\n";
+        return;
+    }
+    cout << "Enter Name: "; cin.ignore(); getline(cin, hc.name);
+    cout << "Enter District: "; getline(cin, hc.district);
+    cout << "Enter Latitude: "; cin >> hc.lat;
+    cout << "Enter Longitude: "; cin >> hc.lon;
+    cout << "Enter Capacity: "; cin >> capacityStr;
+    if (!isNumber(capacityStr)) {
+        cout << "Error: Capacity must be a number.\n";
+        return;
+    }
+    hc.capacity = stoi(capacityStr);
+    hc.node = internNode(hc.id);
+    if (hc.node >= (int)centerSlots.size()) centerSlots.resize(hc.node + 1, -1);
+    centerSlots[hc.node] = centers.size();
+    centers.push_back(hc);
+    networkDirty = true;
+    updateCenterInLayers(hc.node, -1, hc.capacity);
+    updateCenterInSpatialIndex(hc.node, &hc);
+    journalCenter(hc);
+    cout << "Health center added.\n";
+}
+
+void editHealthCenter(CenterId id) {
+    if (!journalWritable()) return;
+    HealthCenter* found = findCenter(id);
+    if (!found) {
+        cout << "Health center with ID " << id << " not found.\n";
+        return;
+    }
+    // Every field is read and checked before the center changes, so a rejected
+    // edit leaves nothing half-applied in memory, the indexes or the journal.
+    HealthCenter& hc = *found;
+    HealthCenter edited = hc;
+    cout << "Editing Health Center ID " << id << "\n";
+    cout << "Enter new Name (current: " << hc.name << "): ";
+    cin.ignore(); getline(cin, edited.name);
+    cout << "Enter new District (current: " << hc.district << "): ";
+    getline(cin, edited.district);
+    cout << "Enter new Latitude (current: " << hc.lat << "): ";
+    cin >> edited.lat;
+    cout << "Enter new Longitude (current: " << hc.lon << "): ";
+    cin >> edited.lon;
+    if (!cin) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Error: Latitude and Longitude must be numbers.\n";
+        return;
+    }
+    string capacityStr;
+    cout << "Enter new Capacity (current: " << hc.capacity << "): ";
+    cin >> capacityStr;
+    if (!isNumber(capacityStr)) {
+        cout << "Error: Capacity must be a number.\n";
+        return;
+    }
+    try {
+        edited.capacity = stoi(capacityStr);
+    } catch (const out_of_range&) {
+        cout << "Error: Capacity is too large.\n";
+        return;
+    }
+
+    int oldCapacity = hc.capacity;
+    bool moved = edited.lat != hc.lat || edited.lon != hc.lon;
+    hc = edited;
+    if (moved) networkDirty = true; // The CSR keeps coordinates for the A* heuristic
+    updateCenterInSpatialIndex(hc.node, &hc);
+    updateCenterInLayers(hc.node, oldCapacity, hc.capacity);
+    journalCenter(hc);
+    cout << "Health center updated.\n";
+}
+
+
+void viewHealthCenters() {
+    if (centers.empty()) {
+        cout << "No health centers available.\n";
+        return;
+    }
+    cout << "\nHealth Centers:\n";
+    cout << "ID  | Name                  | District      | Latitude | Longitude | Capacity\n";
+    cout << "----|-----------------------|---------------|----------|-----------|---------\n";
+    for (const auto& hc : centers) {
+        cout << left << setw(4) << hc.id << "| "
+             << setw(22) << hc.name.substr(0, 21) << "| "
+             << setw(14) << hc.district.substr(0, 13) << "| "
+             << fixed << setprecision(4) << setw(8) << hc.lat << "| "
+             << setw(9) << hc.lon << "| "
+             << hc.capacity << "\n";
+    }
+}
+
+void removeHealthCenter(CenterId id) {
+    if (!journalWritable()) return;
+    HealthCenter* found = findCenter(id);
+    if (!found) {
+        cout << "Health center not found.\n";
+        return;
+    }
+    int node = found->node;
+    *found = move(centers.back());
+    centerSlots[found->node] = found - centers.data();
+    centerSlots[node] = -1;
+    centers.pop_back();
+    updateCenterInSpatialIndex(node, nullptr);
+    ensureAdjacency();
+    detachCenterFromLayers(node);
+    isolateNode(node);
+    connectivity.stale = true;
+    releaseNode(node);
+    repairLayers();
+    journalRecord("X," + to_string(id));
+    cout << "Health center removed.\n";
+}
+
+void addConnection(CenterId fromId, CenterId toId, float distance, int time, const string& desc) {
+    if (!journalWritable()) return;
+    if (!findCenter(fromId) || !findCenter(toId)) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (!(distance >= 0) || time < 0) {
+        cout << "Error: Distance and time must be non-negative.\n";
+        return;
+    }
+    int from = nodeOf(fromId), to = nodeOf(toId);
+    if (findHalfEdge(from, to) >= 0) {
+        cout << "Connection already exists.\n";
+        return;
+    }
+    bool closesCycle = from == to || connected(from, to);
+    insertConnection(from, to, distance, time, desc);
+    relaxLayersAcross(from, to);
+    journalConnection(from, to);
+    cout << "Connection added.\n";
+    if (closesCycle) cout << "It closes a cycle: " << fromId << " and " << toId << " were already connected.\n";
+}
+
+void editConnection(CenterId fromId, CenterId toId) {
+    if (!journalWritable()) return;
+    ensureAdjacency();
+    int from = nodeOf(fromId), to = nodeOf(toId);
+    vector<int> slots = from < 0 || to < 0 ? vector<int>() : connectionSlots(from, to);
+    if (slots.empty()) {
+        cout << "Connection from " << fromId << " to " << toId << " not found.\n";
+        return;
+    }
+    int slot = slots[0];
+    if (slots.size() > 1) {
+        cout << fromId << " and " << toId << " have " << slots.size() << " parallel connections:\n";
+        for (size_t i = 0; i < slots.size(); ++i) {
+            const Connection& c = adjList[from][slots[i]];
+            cout << i + 1 << ". " << c.distance << " km, " << c.time << " min, " << connectionDescriptions[c.descId] << "\n";
+        }
+        size_t choice = 0;
+        cout << "Select connection to edit: ";
+        if (!(cin >> choice) || choice < 1 || choice > slots.size()) {
+            cin.clear();
+            cin.ignore(numeric_limits<streamsize>::max(), '\n');
+            cout << "Invalid selection.\n";
+            return;
+        }
+        slot = slots[choice - 1];
+    }
+    const Connection& c = adjList[from][slot];
+    float distance;
+    int time;
+    string desc;
+    cout << "Editing Connection from " << fromId << " to " << toId << "\n";
+    cout << "Enter new DistanceKM (current: " << c.distance << "): ";
+    cin >> distance;
+    cout << "Enter new TimeMinutes (current: " << c.time << "): ";
+    cin >> time;
+    cout << "Enter new Description (current: " << connectionDescriptions[c.descId] << "): ";
+    cin.ignore(); getline(cin, desc);
+    if (!(distance >= 0) || time < 0) {
+        cout << "Error: Distance and time must be non-negative.\n";
+        return;
+    }
+    detachConnectionFromLayers(from, to);
+    updateConnectionAt(from, slot, distance, time, desc);
+    repairLayers();
+    relaxLayersAcross(from, to);
+    journalConnectionPair(from, to);
+    cout << "Connection updated.\n";
+}
+
+void viewConnections() {
+    ensureAdjacency();
+    set<pair<int, int>> displayed;
+    bool hasConnections = false;
+    cout << "\nConnections:\n";
+    cout << "FromID | ToID | DistanceKM | TimeMinutes | Description\n";
+    cout << "-------|------|------------|-------------|------------\n";
+    for (int i = 0; i < (int)adjList.size(); ++i) {
+        for (const auto& c : adjList[i]) {
+            if (displayed.find({min(i, c.to), max(i, c.to)}) == displayed.end()) {
+                cout << left << setw(7) << idOf(i) << "| "
+                     << setw(5) << idOf(c.to) << "| "
+                     << fixed << setprecision(2) << setw(10) << c.distance << "| "
+                     << setw(11) << c.time << "| "
+                     << connectionDescriptions[c.descId] << "\n";
+                displayed.insert({min(i, c.to), max(i, c.to)});
+                hasConnections = true;
+            }
+        }
+    }
+    if (!hasConnections) {
+        cout << "No connections available.\n";
+    }
+}
+
+void viewRelationships() {
+    ensureAdjacency();
+    ofstream out("relationship_table.csv");
+    out << "HealthCenter,ConnectedCenters,Description\n";
+    cout << "\nHealth Center | Connected Centers        | Description\n";
+    cout << "--------------|-------------------------|-------------------\n";
+    for (const auto& hc : centers) {
+        string links;
+        for (const auto& c : adjList[hc.node]) {
+            links += to_string(idOf(c.to)) + "(" + connectionDescriptions[c.descId] + ") ";
+        }
+        if (links.empty()) links = "None";
+        string desc = hc.description();
+        cout << left << setw(14) << hc.id << "| " << setw(24) << links.substr(0, 23) << "| " << desc << "\n";
+        out << hc.id << "," << links << "," << desc << "\n";
+    }
+    out.close();
+    cout << "\nRelationship table saved to 'relationship_table.csv'.\n";
+}
+
+void removeConnection(CenterId fromId, CenterId toId) {
+    if (!journalWritable()) return;
+    ensureAdjacency();
+    int from = nodeOf(fromId), to = nodeOf(toId);
+    if (from < 0 || to < 0 || findHalfEdge(from, to) < 0) {
+        cout << "Connection not found.\n";
+        return;
+    }
+    detachConnectionFromLayers(from, to);
+    removeConnections(from, to);
+    repairLayers();
+    journalRecord("R," + to_string(fromId) + "," + to_string(toId));
+    cout << "Connection removed.\n";
+}
+
+// Graph Algorithms
+
+// Edge cost a search minimizes: kilometres or minutes.
+enum class RouteMetric { Distance, Time };
+
+template <RouteMetric Metric>
+float edgeCost(const CSRGraph& g, int e) {
+    if constexpr (Metric == RouteMetric::Distance) return g.weights[e];
+    else return (float)g.times[e];
+}
+
+// Single-source Dijkstra over the whole graph. Returns the number of settled nodes.
+template <RouteMetric Metric = RouteMetric::Distance, class Queue>
+int dijkstraCore(const CSRGraph& g, int start, vector<float>& dist, vector<int>& prev, Queue& pq) {
+    int n = g.numNodes();
+    dist.assign(n, INF);
+    prev.assign(n, -1);
+    dist[start] = 0;
+    pq.reset(n);
+    pq.push(start, 0);
+    int settled = 0;
+
+    while (!pq.empty()) {
+        auto [d, u] = pq.pop();
+        if (d > dist[u]) continue;
+        ++settled;
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            float cost = edgeCost<Metric>(g, e);
+            if (dist[v] > dist[u] + cost) {
+                dist[v] = dist[u] + cost;
+                prev[v] = u;
+                pq.push(v, dist[v]);
+            }
+        }
+    }
+    return settled;
+}
+
+int dijkstraSearch(const CSRGraph& g, int start, vector<float>& dist, vector<int>& prev) {
+    ShortestPathQueue pq;
+    return dijkstraCore(g, start, dist, prev, pq);
+}
+
+// Same search minimizing minutes; dist holds minutes.
+int fastestSearch(const CSRGraph& g, int start, vector<float>& dist, vector<int>& prev) {
+    ShortestPathQueue pq;
+    return dijkstraCore<RouteMetric::Time>(g, start, dist, prev, pq);
+}
+
+// Scratch space for one query at a time, kept per thread and reused. A node's
+// dist and prev are valid only while its stamp holds the current search
+// number, so starting a search is O(1) instead of refilling n-sized arrays
+// and a query costs time in proportion to the area it explores. Search
+// numbers are even; the low bit of a stamp marks the node settled.
+struct QueryContext {
+    vector<float> dist;
+    vector<int> prev;
+    vector<unsigned> stamp;
+    unsigned search = 0;
+    ShortestPathQueue pq;
+    vector<pair<float, int>> heap;
+
+    void begin(int n) {
+        if ((int)stamp.size() != n) {
+            dist.resize(n);
+            prev.resize(n);
+            stamp.assign(n, 0);
+            search = 0;
+        }
+        search += 2;
+        if (search == 0) { // Wrapped: clear the stamps once
+            fill(stamp.begin(), stamp.end(), 0);
+            search = 2;
+        }
+    }
+    bool reached(int v) const { return (stamp[v] & ~1u) == search; }
+    bool settled(int v) const { return stamp[v] == (search | 1); }
+    void reach(int v, float d, int from) {
+        stamp[v] = search;
+        dist[v] = d;
+        prev[v] = from;
+    }
+    void settle(int v) { stamp[v] = search | 1; }
+    float distance(int v) const { return reached(v) ? dist[v] : INF; }
+    int parent(int v) const { return reached(v) ? prev[v] : -1; }
+};
+
+QueryContext& queryContext() {
+    thread_local QueryContext context;
+    return context;
+}
+
+// Dijkstra from start that stops once end is settled (end = -1 settles the
+// whole component). Returns the number of settled nodes; afterwards
+// qc.distance(v) and the prev chain are valid for every settled node.
+template <RouteMetric Metric = RouteMetric::Distance>
+int dijkstraQuery(const CSRGraph& g, int start, int end, QueryContext& qc) {
+    qc.begin(g.numNodes());
+    qc.pq.reset(g.numNodes());
+    qc.reach(start, 0, -1);
+    qc.pq.push(start, 0);
+    int settled = 0;
+    while (!qc.pq.empty()) {
+        auto [d, u] = qc.pq.pop();
+        if (d > qc.dist[u]) continue;
+        ++settled;
+        if (u == end) break;
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            float cost = d + edgeCost<Metric>(g, e);
+            if (!qc.reached(v) || cost < qc.dist[v]) {
+                qc.reach(v, cost, u);
+                qc.pq.push(v, cost);
+            }
+        }
+    }
+    return settled;
+}
+
+// Bi-criteria distance/time search
+// Labels are popped in lexicographic (km, minutes) order, so every label
+// already settled at a node is at most as long as any label still to come.
+// A new label is therefore dominated exactly when its minutes are not below
+// the smallest minutes settled at that node, and one int per node replaces
+// the usual per-node label sets. Labels live in a single pool of 16-byte
+// records whose pred field links each route back to the start. Reverse
+// searches from the target give lower bounds on the km and minutes still
+// needed from every node. Their trees also yield the shortest and the fastest
+// route, which are both Pareto-optimal, so a label whose bounds cannot beat
+// either of them, or the target's best minutes so far, is dropped as soon as
+// it is made.
+struct ParetoLabel {
+    float distance;
+    int time;
+    int node;
+    int pred;
+};
+
+struct ParetoRoute {
+    float distance;
+    int time;
+    vector<int> path;
+};
+
+struct ParetoSearch {
+    vector<ParetoLabel> labels;
+    vector<int> bestTime; // Smallest minutes settled per node
+    vector<float> distToEnd, timeToEnd;
+    vector<int> distTree, timeTree;
+    size_t popped = 0;
+};
+
+// Every non-dominated (km, minutes) route from start to end, shortest first.
+// Gives up and returns false once the pool reaches maxLabels labels.
+bool paretoRoutes(const CSRGraph& g, int start, int end, ParetoSearch& ws, vector<ParetoRoute>& routes,
+                  size_t maxLabels = 20000000) {
+    using Entry = tuple<float, int, int>; // distance, time, label
+    priority_queue<Entry, vector<Entry>, greater<>> pq;
+    ws.labels.clear();
+    ws.bestTime.assign(g.numNodes(), numeric_limits<int>::max());
+    ws.popped = 0;
+    routes.clear();
+    // Connections are undirected, so searches from end bound the way there.
+    dijkstraSearch(g, end, ws.distToEnd, ws.distTree);
+    fastestSearch(g, end, ws.timeToEnd, ws.timeTree);
+    if (ws.distToEnd[start] == INF) return true;
+    // Totals of the route that follows a search tree from start to end,
+    // taking the cheapest parallel connection under the tree's own metric.
+    auto follow = [&](const vector<int>& tree, bool byTime) {
+        pair<float, float> total{0, 0};
+        for (int at = start; at != end; at = tree[at]) {
+            int best = -1;
+            for (int e = g.offsets[at]; e < g.offsets[at + 1]; ++e) {
+                if (g.targets[e] != tree[at]) continue;
+                if (best < 0 || (byTime ? g.times[e] < g.times[best] : g.weights[e] < g.weights[best])) best = e;
+            }
+            total.first += g.weights[best];
+            total.second += g.times[best];
+        }
+        return total;
+    };
+    pair<float, float> bounds[2] = {follow(ws.distTree, false), follow(ws.timeTree, true)};
+    for (auto& bound : bounds) bound.first += 1e-4f * max(1.0f, bound.first); // Float rounding margin
+    ws.labels.push_back({0, 0, start, -1});
+    pq.push({0.0f, 0, 0});
+
+    while (!pq.empty()) {
+        int index = get<2>(pq.top());
+        pq.pop();
+        ParetoLabel label = ws.labels[index];
+        if (label.time >= ws.bestTime[label.node]) continue;
+        ws.bestTime[label.node] = label.time;
+        ++ws.popped;
+        if (label.node == end) {
+            routes.push_back({label.distance, label.time, {}});
+            for (int at = index; at != -1; at = ws.labels[at].pred) routes.back().path.push_back(ws.labels[at].node);
+            reverse(routes.back().path.begin(), routes.back().path.end());
+            continue;
+        }
+        for (int e = g.offsets[label.node]; e < g.offsets[label.node + 1]; ++e) {
+            int v = g.targets[e];
+            int time = label.time + g.times[e];
+            float distance = label.distance + g.weights[e];
+            float leastKm = distance + ws.distToEnd[v], leastMinutes = time + ws.timeToEnd[v];
+            if (time >= ws.bestTime[v] || leastMinutes >= ws.bestTime[end]) continue;
+            bool dominated = false;
+            for (const auto& bound : bounds) dominated |= leastKm >= bound.first && leastMinutes >= bound.second;
+            if (dominated) continue;
+            if (ws.labels.size() >= maxLabels) return false;
+            ws.labels.push_back({distance, time, v, index});
+            pq.push({ws.labels.back().distance, time, (int)ws.labels.size() - 1});
+        }
+    }
+    return true;
+}
+
+// K shortest loopless routes (Yen)
+// Every further route leaves one of the routes already accepted at a spur
+// node: the part before the spur is kept, its nodes are blocked, and so are
+// the connections out of the spur taken by accepted routes with the same
+// start. Spur searches are A* on a single reverse Dijkstra from the end,
+// which is an exact bound on the unblocked graph and a valid one once nodes
+// are removed. They share one workspace whose arrays are stamped with a
+// search number instead of cleared. Only the best k - found candidates are
+// kept, and a spur whose bound cannot beat the worst of them is skipped or
+// abandoned as soon as its search frontier passes it.
+struct AlternativeRoute {
+    float distance;
+    int time;
+    vector<int> path;
+    vector<int> arcs; // CSR arc leaving each path node but the last
+};
+
+struct KPathSearch {
+    vector<float> distToEnd;
+    vector<int> endTree;
+    vector<float> dist;
+    vector<int> prev, prevArc;
+    vector<unsigned> reached, blocked; // Search number that last touched each node
+    unsigned stamp = 0;
+    vector<pair<float, int>> heap;
+    vector<int> blockedArcs;
+    size_t spurSearches = 0, spursPruned = 0;
+};
+
+// Starts a new spur search, clearing the stamps when the counter wraps.
+void nextKPathStamp(KPathSearch& ws) {
+    if (++ws.stamp == 0) {
+        fill(ws.reached.begin(), ws.reached.end(), 0);
+        fill(ws.blocked.begin(), ws.blocked.end(), 0);
+        ws.stamp = 1;
+    }
+}
+
+// A* from spur to end around the blocked nodes and arcs. Returns the
+// distance, or INF when end is unreachable or no route is shorter than limit.
+float spurSearch(const CSRGraph& g, int spur, int end, float limit, KPathSearch& ws) {
+    auto later = greater<pair<float, int>>();
+    ws.heap.clear();
+    ws.reached[spur] = ws.stamp;
+    ws.dist[spur] = 0;
+    ws.prev[spur] = -1;
+    ws.heap.push_back({ws.distToEnd[spur], spur});
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), later);
+        auto [key, u] = ws.heap.back();
+        ws.heap.pop_back();
+        if (key > ws.dist[u] + ws.distToEnd[u]) continue;
+        if (key >= limit) return INF;
+        if (u == end) return ws.dist[u];
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            if (ws.blocked[v] == ws.stamp || ws.distToEnd[v] == INF) continue;
+            if (u == spur && find(ws.blockedArcs.begin(), ws.blockedArcs.end(), e) != ws.blockedArcs.end()) continue;
+            float d = ws.dist[u] + g.weights[e];
+            if (ws.reached[v] != ws.stamp || d < ws.dist[v]) {
+                ws.reached[v] = ws.stamp;
+                ws.dist[v] = d;
+                ws.prev[v] = u;
+                ws.prevArc[v] = e;
+                ws.heap.push_back({d + ws.distToEnd[v], v});
+                push_heap(ws.heap.begin(), ws.heap.end(), later);
+            }
+        }
+    }
+    return INF;
+}
+
+// Up to k loopless routes from start to end, shortest first.
+void kShortestRoutes(const CSRGraph& g, int start, int end, int k, KPathSearch& ws, vector<AlternativeRoute>& routes) {
+    routes.clear();
+    ws.spurSearches = ws.spursPruned = 0;
+    if (k <= 0) return;
+    int n = g.numNodes();
+    dijkstraSearch(g, end, ws.distToEnd, ws.endTree);
+    if (ws.distToEnd[start] == INF) return;
+    if ((int)ws.reached.size() != n) {
+        ws.dist.assign(n, INF);
+        ws.prev.assign(n, -1);
+        ws.prevArc.assign(n, -1);
+        ws.reached.assign(n, 0);
+        ws.blocked.assign(n, 0);
+        ws.stamp = 0;
+    }
+    auto finish = [&](AlternativeRoute& route) {
+        route.distance = 0;
+        route.time = 0;
+        for (int e : route.arcs) {
+            route.distance += g.weights[e];
+            route.time += g.times[e];
+        }
+    };
+
+    // The reverse tree already holds the shortest route; take the shortest
+    // of any parallel connections along it.
+    AlternativeRoute first;
+    for (int at = start; at != end; at = ws.endTree[at]) {
+        int best = -1;
+        for (int e = g.offsets[at]; e < g.offsets[at + 1]; ++e) {
+            if (g.targets[e] == ws.endTree[at] && (best < 0 || g.weights[e] < g.weights[best])) best = e;
+        }
+        first.path.push_back(at);
+        first.arcs.push_back(best);
+    }
+    first.path.push_back(end);
+    finish(first);
+    routes.push_back(move(first));
+
+    vector<AlternativeRoute> pool;
+    set<pair<float, int>> ranked; // (distance, pool index) of the kept candidates
+    set<vector<int>> seen;        // Arc sequences already accepted or offered
+    seen.insert(routes[0].arcs);
+    while ((int)routes.size() < k) {
+        const AlternativeRoute& last = routes.back();
+        size_t needed = k - routes.size();
+        float root = 0;
+        for (size_t i = 0; i < last.arcs.size(); root += g.weights[last.arcs[i]], ++i) {
+            int spur = last.path[i];
+            float bound = ranked.size() >= needed ? prev(ranked.end())->first : INF;
+            if (root + ws.distToEnd[spur] >= bound) {
+                ++ws.spursPruned;
+                continue;
+            }
+            nextKPathStamp(ws);
+            for (size_t j = 0; j < i; ++j) ws.blocked[last.path[j]] = ws.stamp;
+            ws.blockedArcs.clear();
+            for (const auto& route : routes) {
+                if (route.arcs.size() > i && equal(last.arcs.begin(), last.arcs.begin() + i, route.arcs.begin())) {
+                    ws.blockedArcs.push_back(route.arcs[i]);
+                }
+            }
+            ++ws.spurSearches;
+            if (spurSearch(g, spur, end, bound - root, ws) == INF) continue;
+
+            AlternativeRoute candidate;
+            candidate.path.assign(last.path.begin(), last.path.begin() + i);
+            candidate.arcs.assign(last.arcs.begin(), last.arcs.begin() + i);
+            size_t cut = candidate.path.size();
+            for (int at = end; at != spur; at = ws.prev[at]) {
+                candidate.path.push_back(at);
+                candidate.arcs.push_back(ws.prevArc[at]);
+            }
+            candidate.path.push_back(spur);
+            reverse(candidate.path.begin() + cut, candidate.path.end());
+            reverse(candidate.arcs.begin() + cut, candidate.arcs.end());
+            if (!seen.insert(candidate.arcs).second) continue;
+            finish(candidate);
+            ranked.insert({candidate.distance, (int)pool.size()});
+            pool.push_back(move(candidate));
+            if (ranked.size() > needed) ranked.erase(prev(ranked.end()));
+        }
+        if (ranked.empty()) break;
+        routes.push_back(move(pool[ranked.begin()->second]));
+        ranked.erase(ranked.begin());
+    }
+}
+
+// Goal-directed A* search from start to end using the scaled great-circle
+// distance as a lower bound. Stops as soon as end is settled. Returns the
+// number of settled nodes; qc.distance(end) is INF when end is unreachable.
+int aStarSearch(const CSRGraph& g, int start, int end, QueryContext& qc) {
+    qc.begin(g.numNodes());
+    float targetLat = g.lat[end], targetLon = g.lon[end];
+    auto heuristic = [&](int u) {
+        return g.heuristicScale * haversineKm(g.lat[u], g.lon[u], targetLat, targetLon);
+    };
+
+    auto later = greater<pair<float, int>>();
+    qc.heap.clear();
+    qc.reach(start, 0, -1);
+    qc.heap.push_back({heuristic(start), start});
+    int settled = 0;
+
+    while (!qc.heap.empty()) {
+        pop_heap(qc.heap.begin(), qc.heap.end(), later);
+        int u = qc.heap.back().second;
+        qc.heap.pop_back();
+        if (qc.settled(u)) continue;
+        qc.settle(u);
+        ++settled;
+        if (u == end) break;
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            float d = qc.dist[u] + g.weights[e];
+            if (!qc.settled(v) && (!qc.reached(v) || d < qc.dist[v])) {
+                qc.reach(v, d, u);
+                qc.heap.push_back({d + heuristic(v), v});
+                push_heap(qc.heap.begin(), qc.heap.end(), later);
+            }
+        }
+    }
+    return settled;
+}
+
+void printPath(const vector<int>& prev, int end) {
+    cout << "Path: ";
+    vector<int> path;
+    for (int at = end; at != -1; at = prev[at]) path.push_back(at);
+    for (int i = path.size() - 1; i >= 0; --i) cout << idOf(path[i]) << (i > 0 ? " -> " : "\n");
+}
+
+// Defined with the landmark (ALT) routing below.
+struct LandmarkTable;
+const LandmarkTable* freshLandmarks(const string& filename);
+int altSearch(const CSRGraph& g, const LandmarkTable& table, int start, int end, QueryContext& qc, vector<int>& active);
+
+void dijkstra(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (!connected(start, end)) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    QueryContext& qc = queryContext();
+    if (const LandmarkTable* table = freshLandmarks("connections.alt")) {
+        vector<int> active;
+        altSearch(graph(), *table, start, end, qc, active);
+    } else {
+        dijkstraQuery(graph(), start, end, qc);
+    }
+
+    if (qc.distance(end) == INF) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+
+    cout << "Shortest Distance from " << startId << " to " << endId << ": " << qc.dist[end] << " km\n";
+    printPath(qc.prev, end);
+}
+
+void aStar(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (!connected(start, end)) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    QueryContext& qc = queryContext();
+    int settled = aStarSearch(graph(), start, end, qc);
+
+    if (qc.distance(end) == INF) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+
+    cout << "Shortest Distance from " << startId << " to " << endId << ": " << qc.dist[end] << " km"
+         << " (" << settled << " centers settled)\n";
+    printPath(qc.prev, end);
+}
+
+void fastestRoute(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (!connected(start, end)) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    const CSRGraph& g = graph();
+    QueryContext& qc = queryContext();
+    dijkstraQuery<RouteMetric::Time>(g, start, end, qc);
+    const vector<float>& minutes = qc.dist;
+    const vector<int>& prev = qc.prev;
+
+    float km = 0;
+    for (int at = end; prev[at] != -1; at = prev[at]) {
+        for (int e = g.offsets[prev[at]]; e < g.offsets[prev[at] + 1]; ++e) {
+            if (g.targets[e] == at && (float)g.times[e] == minutes[at] - minutes[prev[at]]) {
+                km += g.weights[e];
+                break;
+            }
+        }
+    }
+    cout << "Fastest Route from " << startId << " to " << endId << ": " << minutes[end] << " min (" << km << " km)\n";
+    printPath(prev, end);
+}
+
+void paretoRouting(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (!connected(start, end)) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    ParetoSearch ws;
+    vector<ParetoRoute> routes;
+    if (!paretoRoutes(graph(), start, end, ws, routes)) {
+        cout << "Search stopped at its label limit; routes below may be incomplete.\n";
+    }
+    cout << routes.size() << " non-dominated route(s) from " << startId << " to " << endId << ":\n";
+    for (const auto& route : routes) {
+        cout << route.distance << " km, " << route.time << " min: ";
+        for (size_t i = 0; i < route.path.size(); ++i) cout << idOf(route.path[i]) << (i + 1 < route.path.size() ? " -> " : "\n");
+    }
+}
+
+void alternativeRoutes(CenterId startId, CenterId endId, int k) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    if (k < 1) {
+        cout << "K must be at least 1.\n";
+        return;
+    }
+    if (!connected(start, end)) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    KPathSearch ws;
+    vector<AlternativeRoute> routes;
+    kShortestRoutes(graph(), start, end, k, ws, routes);
+    cout << routes.size() << " route(s) from " << startId << " to " << endId << ":\n";
+    for (size_t r = 0; r < routes.size(); ++r) {
+        cout << r + 1 << ". " << routes[r].distance << " km, " << routes[r].time << " min: ";
+        for (size_t i = 0; i < routes[r].path.size(); ++i) {
+            cout << idOf(routes[r].path[i]) << (i + 1 < routes[r].path.size() ? " -> " : "\n");
+        }
+    }
+}
+
+// Breadth-first order of everything reachable from start. qc.parent(v)
+// records the BFS tree (the start is its own parent) and qc.dist the hops.
+void bfsOrder(const CSRGraph& g, int start, QueryContext& qc, vector<int>& order) {
+    qc.begin(g.numNodes());
+    order.clear();
+    qc.reach(start, 0, start);
+    order.push_back(start);
+    for (size_t head = 0; head < order.size(); ++head) {
+        int u = order[head];
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            if (!qc.reached(v)) {
+                qc.reach(v, qc.dist[u] + 1, u);
+                order.push_back(v);
+            }
+        }
+    }
+}
+
+void bfs(CenterId startId) {
+    int start = queryNode(startId);
+    if (start < 0) {
+        cout << "Invalid health center ID.\n";
+        return;
+    }
+    vector<int> order;
+    bfsOrder(graph(), start, queryContext(), order);
+    cout << "BFS Traversal: ";
+    for (int u : order) cout << idOf(u) << " ";
+    cout << endl;
+}
+
+// Workspace for hopDistances, reusable across searches. hops[v] is the
+// number of connections from the nearest source, -1 if v was not reached.
+struct HopSearch {
+    vector<int> hops;
+    vector<atomic<uint64_t>> visited;
+    vector<uint64_t> frontierBits, nextBits;
+    vector<int> frontier;
+    vector<vector<int>> workerNext;
+    vector<int> workerFound;
+};
+
+// Direction-optimizing BFS (Beamer et al.) from every source at once, up to
+// maxHops levels (unlimited when negative). Small frontiers expand top-down
+// from a node list. Once a growing frontier holds at least n/24 nodes and
+// outnumbers the nodes still unvisited, levels switch to bottom-up, where
+// each unvisited node scans its neighbours for one in the frontier bitmap;
+// they switch back once a shrinking frontier falls under n/24 nodes.
+// Beamer's switch point (frontier edges above 1/14 of unvisited edges) suits
+// low-diameter graphs. On road networks the frontier is a thin shell, most
+// unvisited nodes scan all their neighbours in vain, and `--bench hops`
+// showed bottom-up only paying once the frontier outnumbers the rest. Degrees
+// are nearly uniform, so node counts stand in for edge counts without a
+// random read of every discovered node's degree. With parallel set each
+// level is split over the worker pool; top-down claims nodes with an atomic
+// bit, bottom-up hands each thread whole bitmap words. Returns the number of
+// nodes reached.
+int hopDistances(const CSRGraph& g, const vector<int>& sources, int maxHops, HopSearch& ws, bool parallel) {
+    const size_t TOP_DOWN_CHUNK = 1024, BOTTOM_UP_WORDS = 64;
+    int n = g.numNodes();
+    size_t words = (n + 63) / 64;
+    unsigned workers = parallel ? workerPool().size() : 1;
+    ws.hops.assign(n, -1);
+    if (ws.visited.size() != words) ws.visited = vector<atomic<uint64_t>>(words);
+    for (auto& w : ws.visited) w.store(0, memory_order_relaxed);
+    ws.frontierBits.assign(words, 0);
+    ws.nextBits.assign(words, 0);
+    ws.workerNext.resize(workers);
+    ws.workerFound.assign(workers, 0);
+    ws.frontier.clear();
+
+    auto forChunks = [&](size_t chunks, const auto& fn) {
+        if (parallel && chunks > 1) {
+            workerPool().parallelFor(chunks, fn);
+        } else {
+            for (size_t c = 0; c < chunks; ++c) fn(c, 0);
+        }
+    };
+    auto isSet = [](const auto& bits, int v) { return (bits[v >> 6] & (1ULL << (v & 63))) != 0; };
+
+    for (int s : sources) {
+        uint64_t bit = 1ULL << (s & 63);
+        if (ws.visited[s >> 6].fetch_or(bit, memory_order_relaxed) & bit) continue;
+        ws.hops[s] = 0;
+        ws.frontier.push_back(s);
+    }
+    int reached = ws.frontier.size();
+    size_t frontierSize = ws.frontier.size(), previousSize = 0;
+    bool bottomUp = false;
+
+    for (int level = 0; frontierSize > 0 && (maxHops < 0 || level < maxHops); ++level) {
+        bool wasBottomUp = bottomUp;
+        bool growing = frontierSize > previousSize;
+        if (!bottomUp && growing && frontierSize >= (size_t)n / 24 && frontierSize > (size_t)(n - reached)) {
+            bottomUp = true;
+        } else if (bottomUp && !growing && frontierSize < (size_t)n / 24) {
+            bottomUp = false;
+        }
+        previousSize = frontierSize;
+
+        if (bottomUp && !wasBottomUp) {
+            fill(ws.frontierBits.begin(), ws.frontierBits.end(), 0);
+            for (int u : ws.frontier) ws.frontierBits[u >> 6] |= 1ULL << (u & 63);
+        } else if (!bottomUp && wasBottomUp) {
+            ws.frontier.clear();
+            for (size_t w = 0; w < words; ++w) {
+                for (uint64_t bits = ws.frontierBits[w]; bits; bits &= bits - 1) {
+                    ws.frontier.push_back(w * 64 + trailingZeros(bits));
+                }
+            }
+        }
+        for (auto& next : ws.workerNext) next.clear();
+        fill(ws.workerFound.begin(), ws.workerFound.end(), 0);
+
+        if (bottomUp) {
+            forChunks((words + BOTTOM_UP_WORDS - 1) / BOTTOM_UP_WORDS, [&](size_t chunk, unsigned worker) {
+                size_t end = min(words, (chunk + 1) * BOTTOM_UP_WORDS);
+                int found = 0;
+                for (size_t w = chunk * BOTTOM_UP_WORDS; w < end; ++w) {
+                    uint64_t seen = ws.visited[w].load(memory_order_relaxed), added = 0;
+                    for (int v = w * 64; v < min<int>(n, w * 64 + 64); ++v) {
+                        if (seen & (1ULL << (v & 63))) continue;
+                        for (int e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+                            if (isSet(ws.frontierBits, g.targets[e])) {
+                                ws.hops[v] = level + 1;
+                                added |= 1ULL << (v & 63);
+                                ++found;
+                                break;
+                            }
+                        }
+                    }
+                    ws.nextBits[w] = added;
+                    ws.visited[w].store(seen | added, memory_order_relaxed);
+                }
+                ws.workerFound[worker] += found;
+            });
+            ws.frontierBits.swap(ws.nextBits);
+        } else {
+            forChunks((ws.frontier.size() + TOP_DOWN_CHUNK - 1) / TOP_DOWN_CHUNK, [&](size_t chunk, unsigned worker) {
+                size_t end = min(ws.frontier.size(), (chunk + 1) * TOP_DOWN_CHUNK);
+                vector<int>& next = ws.workerNext[worker];
+                for (size_t i = chunk * TOP_DOWN_CHUNK; i < end; ++i) {
+                    int u = ws.frontier[i];
+                    for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                        int v = g.targets[e];
+                        uint64_t bit = 1ULL << (v & 63);
+                        uint64_t seen = ws.visited[v >> 6].load(memory_order_relaxed);
+                        if (seen & bit) continue;
+                        if (!parallel) {
+                            ws.visited[v >> 6].store(seen | bit, memory_order_relaxed);
+                        } else if (ws.visited[v >> 6].fetch_or(bit, memory_order_relaxed) & bit) {
+                            continue;
+                        }
+                        ws.hops[v] = level + 1;
+                        next.push_back(v);
+                    }
+                }
+            });
+            if (workers == 1) {
+                ws.frontier.swap(ws.workerNext[0]);
+            } else {
+                ws.frontier.clear();
+                for (const auto& next : ws.workerNext) ws.frontier.insert(ws.frontier.end(), next.begin(), next.end());
+            }
+        }
+
+        frontierSize = 0;
+        if (bottomUp) {
+            for (int found : ws.workerFound) frontierSize += found;
+        } else {
+            frontierSize = ws.frontier.size();
+        }
+        reached += frontierSize;
+    }
+    return reached;
+}
+
+// Lists every center within maxHops connections of any of the sources.
+void centersWithinHops(const vector<CenterId>& sources, int maxHops) {
+    vector<int> valid;
+    for (CenterId s : sources) {
+        int node = queryNode(s);
+        if (node >= 0) valid.push_back(node);
+        else cout << "Skipping invalid health center ID " << s << ".\n";
+    }
+    if (valid.empty()) return;
+    const CSRGraph& g = graph();
+    HopSearch ws;
+    hopDistances(g, valid, maxHops, ws, true);
+    vector<vector<CenterId>> byHops(maxHops + 1);
+    for (const auto& hc : centers) {
+        if (ws.hops[hc.node] >= 0) byHops[ws.hops[hc.node]].push_back(hc.id);
+    }
+    for (int h = 0; h <= maxHops; ++h) {
+        if (byHops[h].empty()) continue;
+        cout << h << " hop" << (h == 1 ? "" : "s") << ":";
+        for (CenterId id : byHops[h]) cout << " " << id;
+        cout << "\n";
+    }
+}
+
+bool hasCycle() {
+    return connectivityIndex().cycleEdges > 0;
+}
+
+void detectCycle() {
+    cout << (hasCycle() ? "Cycle detected in the network.\n" : "No cycle found in the network.\n");
+}
+
+// Floyd-Warshall tile kernel: c[i][j] = min(c[i][j], a[i][k] + b[k][j]) for
+// one FW_TILE x FW_TILE tile. The k loop is outermost so the kernel stays
+// correct when c aliases a or b, as it does for the diagonal, row and column
+// tiles of each round.
+const int FW_TILE = 64;
+
+void minPlusTileScalar(float* c, const float* a, const float* b, int stride) {
+    for (int k = 0; k < FW_TILE; ++k) {
+        const float* bk = b + (size_t)k * stride;
+        for (int i = 0; i < FW_TILE; ++i) {
+            float aik = a[(size_t)i * stride + k];
+            float* ci = c + (size_t)i * stride;
+            for (int j = 0; j < FW_TILE; ++j) ci[j] = min(ci[j], aik + bk[j]);
+        }
+    }
+}
+
+#ifdef HAVE_X86_SIMD
+__attribute__((target("avx2")))
+void minPlusTileAvx2(float* c, const float* a, const float* b, int stride) {
+    for (int k = 0; k < FW_TILE; ++k) {
+        const float* bk = b + (size_t)k * stride;
+        for (int i = 0; i < FW_TILE; ++i) {
+            __m256 aik = _mm256_set1_ps(a[(size_t)i * stride + k]);
+            float* ci = c + (size_t)i * stride;
+            for (int j = 0; j < FW_TILE; j += 8) {
+                __m256 via = _mm256_add_ps(aik, _mm256_load_ps(bk + j));
+                _mm256_store_ps(ci + j, _mm256_min_ps(_mm256_load_ps(ci + j), via));
+            }
+        }
+    }
+}
+
+// Variant for tiles that alias neither input: each row of c is kept in
+// registers while the whole k range is folded into it.
+__attribute__((target("avx2")))
+void minPlusTileIndependentAvx2(float* c, const float* a, const float* b, int stride) {
+    for (int i = 0; i < FW_TILE; ++i) {
+        float* ci = c + (size_t)i * stride;
+        const float* ai = a + (size_t)i * stride;
+        __m256 acc[FW_TILE / 8];
+        for (int v = 0; v < FW_TILE / 8; ++v) acc[v] = _mm256_load_ps(ci + v * 8);
+        for (int k = 0; k < FW_TILE; ++k) {
+            __m256 aik = _mm256_set1_ps(ai[k]);
+            const float* bk = b + (size_t)k * stride;
+            for (int v = 0; v < FW_TILE / 8; ++v) {
+                acc[v] = _mm256_min_ps(acc[v], _mm256_add_ps(aik, _mm256_load_ps(bk + v * 8)));
+            }
+        }
+        for (int v = 0; v < FW_TILE / 8; ++v) _mm256_store_ps(ci + v * 8, acc[v]);
+    }
+}
+
+static const bool cpuHasAvx2 = __builtin_cpu_supports("avx2");
+#endif
+
+void minPlusTile(float* c, const float* a, const float* b, int stride) {
+#ifdef HAVE_X86_SIMD
+    if (cpuHasAvx2) {
+        minPlusTileAvx2(c, a, b, stride);
+        return;
+    }
+#endif
+    minPlusTileScalar(c, a, b, stride);
+}
+
+void minPlusTileIndependent(float* c, const float* a, const float* b, int stride) {
+#ifdef HAVE_X86_SIMD
+    if (cpuHasAvx2) {
+        minPlusTileIndependentAvx2(c, a, b, stride);
+        return;
+    }
+#endif
+    minPlusTileScalar(c, a, b, stride);
+}
+
+// Blocked all-pairs shortest paths over the dense matrix d. Each round first
+// closes the diagonal tile, then the tiles in its row and column, then every
+// remaining tile; tiles within a phase are independent and run on the pool.
+void blockedFloydWarshall(DistanceMatrix& d) {
+    int stride = d.rowStride();
+    int tiles = stride / FW_TILE;
+    auto tile = [&](int bi, int bj) { return d.row(bi * FW_TILE) + bj * FW_TILE; };
+    ThreadPool& pool = workerPool();
+
+    for (int kb = 0; kb < tiles; ++kb) {
+        float* diag = tile(kb, kb);
+        minPlusTile(diag, diag, diag, stride);
+
+        pool.parallelFor(2 * (tiles - 1), [&](size_t idx, unsigned) {
+            int other = (int)idx % (tiles - 1);
+            if (other >= kb) ++other;
+            if ((int)idx < tiles - 1) {
+                float* c = tile(kb, other);
+                minPlusTile(c, diag, c, stride);
+            } else {
+                float* c = tile(other, kb);
+                minPlusTile(c, c, diag, stride);
+            }
+        });
+
+        pool.parallelFor((size_t)(tiles - 1) * (tiles - 1), [&](size_t idx, unsigned) {
+            int bi = (int)idx / (tiles - 1), bj = (int)idx % (tiles - 1);
+            if (bi >= kb) ++bi;
+            if (bj >= kb) ++bj;
+            minPlusTileIndependent(tile(bi, bj), tile(bi, kb), tile(kb, bj), stride);
+        });
+    }
+}
+
+// Fills fwDistances for every center plus any connection endpoint without a
+// center record, using dense indices in fwNodes order.
+void computeAllPairs() {
+    const CSRGraph& g = graph();
+    vector<int> denseOf(g.numNodes(), -1);
+    fwNodes.clear();
+    for (const auto& hc : centers) {
+        if (denseOf[hc.node] == -1) {
+            denseOf[hc.node] = (int)fwNodes.size();
+            fwNodes.push_back(hc.node);
+        }
+    }
+    for (int u = 0; u < g.numNodes(); ++u) {
+        if (denseOf[u] == -1 && g.degree(u) > 0) {
+            denseOf[u] = (int)fwNodes.size();
+            fwNodes.push_back(u);
+        }
+    }
+
+    int n = (int)fwNodes.size();
+    fwDistances.reset(n, FW_TILE, INF);
+    for (int i = 0; i < n; ++i) {
+        float* row = fwDistances.row(i);
+        row[i] = 0;
+        int u = fwNodes[i];
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int j = denseOf[g.targets[e]];
+            row[j] = min(row[j], g.weights[e]);
+        }
+    }
+    blockedFloydWarshall(fwDistances);
+}
+
+void floydWarshall() {
+    computeAllPairs();
+
+    cout << "Floyd-Warshall All-Pairs Shortest Paths:\n";
+    int numCenters = (int)centers.size();
+    for (int i = 0; i < numCenters; ++i) {
+        for (int j = 0; j < numCenters; ++j) {
+            float d = fwDistances.at(i, j);
+            if (i != j && d < INF) {
+                cout << "From " << idOf(fwNodes[i]) << " to " << idOf(fwNodes[j]) << ": " << d << " km\n";
+            }
+        }
+    }
+}
+
+// Lazy Prim over the component containing start; qc.parent(v) and qc.dist[v]
+// give the tree edge that attached v.
+void primTree(const CSRGraph& g, int start, QueryContext& qc) {
+    auto later = greater<pair<float, int>>();
+    qc.begin(g.numNodes());
+    qc.heap.clear();
+    qc.reach(start, 0, -1);
+    qc.heap.push_back({0, start});
+
+    while (!qc.heap.empty()) {
+        pop_heap(qc.heap.begin(), qc.heap.end(), later);
+        int u = qc.heap.back().second;
+        qc.heap.pop_back();
+        if (qc.settled(u)) continue;
+        qc.settle(u);
+
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            if (!qc.settled(v) && (!qc.reached(v) || g.weights[e] < qc.dist[v])) {
+                qc.reach(v, g.weights[e], u);
+                qc.heap.push_back({g.weights[e], v});
+                push_heap(qc.heap.begin(), qc.heap.end(), later);
+            }
+        }
+    }
+}
+
+void primMST(int numCenters) {
+    if (centers.empty()) {
+        cout << "No health centers available for MST.\n";
+        return;
+    }
+
+    QueryContext& qc = queryContext();
+    primTree(graph(), centers[0].node, qc);
+
+    cout << "Minimum Spanning Tree Edges:\n";
+    float totalCost = 0;
+    for (int i = 0; i < numCenters; ++i) {
+        int v = centers[i].node;
+        if (qc.parent(v) != -1) {
+            cout << idOf(qc.prev[v]) << " - " << centers[i].id << ": " << qc.dist[v] << " km\n";
+            totalCost += qc.dist[v];
+        }
+    }
+    cout << "Total MST Cost: " << totalCost << " km\n";
+}
+
+struct ForestEdge {
+    int u, v;
+    float w;
+};
+
+// Every connection once (u < v), self-loops dropped.
+vector<ForestEdge> forestEdges(const CSRGraph& g) {
+    vector<ForestEdge> edges;
+    edges.reserve(g.numEdges() / 2);
+    for (int u = 0; u < g.numNodes(); ++u) {
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            if (u < g.targets[e]) edges.push_back({u, g.targets[e], g.weights[e]});
+        }
+    }
+    return edges;
+}
+
+// Distances are non-negative floats, whose bit patterns order the same way as
+// their values, so an LSD radix sort on the 32-bit pattern sorts by distance.
+void radixSortByWeight(vector<ForestEdge>& edges) {
+    vector<ForestEdge> buffer(edges.size());
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t count[257] = {};
+        for (const ForestEdge& e : edges) ++count[((floatBits(e.w) >> shift) & 0xFF) + 1];
+        if (count[1] == edges.size()) continue; // Byte is zero everywhere
+        for (int b = 0; b < 256; ++b) count[b + 1] += count[b];
+        for (const ForestEdge& e : edges) buffer[count[(floatBits(e.w) >> shift) & 0xFF]++] = e;
+        edges.swap(buffer);
+    }
+}
+
+// Minimum spanning forest by Kruskal: one tree per connected component.
+float kruskalForest(const CSRGraph& g, vector<ForestEdge>& forest) {
+    vector<ForestEdge> edges = forestEdges(g);
+    radixSortByWeight(edges);
+    DisjointSets sets;
+    sets.reset(g.numNodes());
+    forest.clear();
+    float total = 0;
+    for (const ForestEdge& e : edges) {
+        if (sets.unite(e.u, e.v)) {
+            forest.push_back(e);
+            total += e.w;
+        }
+    }
+    return total;
+}
+
+// Minimum spanning forest by Boruvka. Each round every component picks its
+// cheapest outgoing edge, ties broken by edge index so the picks never close
+// a cycle; the scan is split over the worker pool with an atomic minimum per
+// component. Edges inside a component are filtered out between rounds.
+float boruvkaForest(const CSRGraph& g, vector<ForestEdge>& forest, bool parallel) {
+    const size_t CHUNK = 1 << 14;
+    const uint64_t NONE = numeric_limits<uint64_t>::max();
+    int n = g.numNodes();
+    vector<ForestEdge> edges = forestEdges(g);
+    DisjointSets sets;
+    sets.reset(n);
+    vector<int> comp(n);
+    vector<atomic<uint64_t>> best(n);
+    forest.clear();
+    float total = 0;
+
+    while (!edges.empty()) {
+        for (int u = 0; u < n; ++u) {
+            comp[u] = sets.find(u);
+            best[u].store(NONE, memory_order_relaxed);
+        }
+        auto offer = [&](int c, uint64_t key) {
+            uint64_t current = best[c].load(memory_order_relaxed);
+            while (key < current && !best[c].compare_exchange_weak(current, key, memory_order_relaxed)) {}
+        };
+        auto scan = [&](size_t chunk, unsigned) {
+            size_t end = min(edges.size(), (chunk + 1) * CHUNK);
+            for (size_t i = chunk * CHUNK; i < end; ++i) {
+                int cu = comp[edges[i].u], cv = comp[edges[i].v];
+                if (cu == cv) continue;
+                uint64_t key = (uint64_t)floatBits(edges[i].w) << 32 | i;
+                offer(cu, key);
+                offer(cv, key);
+            }
+        };
+        size_t chunks = (edges.size() + CHUNK - 1) / CHUNK;
+        if (parallel) {
+            workerPool().parallelFor(chunks, scan);
+        } else {
+            for (size_t c = 0; c < chunks; ++c) scan(c, 0);
+        }
+
+        bool merged = false;
+        for (int c = 0; c < n; ++c) {
+            uint64_t key = best[c].load(memory_order_relaxed);
+            if (key == NONE) continue;
+            const ForestEdge& e = edges[(uint32_t)key];
+            if (sets.unite(e.u, e.v)) {
+                forest.push_back(e);
+                total += e.w;
+                merged = true;
+            }
+        }
+        if (!merged) break;
+        edges.erase(remove_if(edges.begin(), edges.end(),
+                              [&](const ForestEdge& e) { return sets.find(e.u) == sets.find(e.v); }),
+                    edges.end());
+    }
+    return total;
+}
+
+// Boruvka only pays for its extra rounds when there are cores to spread the
+// edge scans over; on one core Kruskal's single sorted pass is faster.
+float minimumSpanningForest(const CSRGraph& g, vector<ForestEdge>& forest) {
+    if (workerPool().size() > 1 && g.numEdges() >= 200000) return boruvkaForest(g, forest, true);
+    return kruskalForest(g, forest);
+}
+
+void spanningForest() {
+    if (centers.empty()) {
+        cout << "No health centers available for MST.\n";
+        return;
+    }
+    vector<ForestEdge> forest;
+    float totalCost = minimumSpanningForest(graph(), forest);
+    cout << "Minimum Spanning Forest Edges:\n";
+    for (const ForestEdge& e : forest) cout << idOf(e.u) << " - " << idOf(e.v) << ": " << e.w << " km\n";
+    // Connections can reference ids with no center record, so components are
+    // counted over live nodes, each forest edge joining two of them.
+    size_t liveNodes = nodeIds.size() - freeNodes.size();
+    cout << "Total Forest Cost: " << totalCost << " km over " << liveNodes - forest.size() << " component(s)\n";
+}
+
+void emergencyRouting(CenterId startId, int minCapacity) {
+    int start = queryNode(startId);
+    if (start < 0) {
+        cout << "Invalid health center ID.\n";
+        return;
+    }
+    const CapacityLayer& layer = capacityLayer(minCapacity);
+    int bestCenter = layer.owner[start];
+
+    if (bestCenter < 0) {
+        cout << "No health center with capacity >= " << minCapacity << " found.\n";
+        return;
+    }
+
+    cout << "Nearest health center with capacity >= " << minCapacity << ": ID " << idOf(bestCenter) << ", Distance: " << layer.dist[start] << " km\n";
+    cout << "Path: ";
+    for (int at = start; at != -1; at = layer.nextHop[at]) cout << idOf(at) << (at != bestCenter ? " -> " : "\n");
+}
+
+// Maps a GPS fix onto the network: the node of the nearest of the 8 closest
+// centers that has a connection, or of the closest center if none do. Returns -1 when
+// there are no centers; offsetKm is the straight-line distance to it.
+int snapToNetwork(float lat, float lon, float& offsetKm) {
+    vector<pair<float, int>> nearest = nearestCenters(lat, lon, 8);
+    if (nearest.empty()) return -1;
+    const CSRGraph& g = graph();
+    pair<float, int> chosen = nearest[0];
+    for (const auto& candidate : nearest) {
+        if (candidate.second < g.numNodes() && g.degree(candidate.second) > 0) {
+            chosen = candidate;
+            break;
+        }
+    }
+    offsetKm = chosen.first;
+    return chosen.second;
+}
+
+// Id of the center a GPS fix snaps to, or -1 when there are no centers.
+CenterId snapAndReport(float lat, float lon) {
+    float offsetKm = 0;
+    int start = snapToNetwork(lat, lon, offsetKm);
+    if (start < 0) {
+        cout << "No health centers available.\n";
+        return -1;
+    }
+    cout << "GPS point snapped to health center " << idOf(start) << " (" << offsetKm << " km away).\n";
+    return idOf(start);
+}
+
+void emergencyRoutingFromGps(float lat, float lon, int minCapacity) {
+    CenterId start = snapAndReport(lat, lon);
+    if (start >= 0) emergencyRouting(start, minCapacity);
+}
+
+void dijkstraFromGps(float lat, float lon, CenterId end) {
+    CenterId start = snapAndReport(lat, lon);
+    if (start >= 0) dijkstra(start, end);
+}
+
+void printNearbyCenters(const vector<pair<float, int>>& found) {
+    if (found.empty()) {
+        cout << "No health centers found.\n";
+        return;
+    }
+    for (const auto& entry : found) cout << "ID " << idOf(entry.second) << ": " << entry.first << " km\n";
+}
+
+// Mass-casualty assignment
+// Patients waiting at casualty sites are sent to centers so that no center
+// takes more than its capacity and the total road distance is minimal. This
+// is a min-cost flow: a super-source feeds each site its patients, every
+// connection carries any number of patients in either direction at its
+// length in metres, and each center drains into a super-sink up to its
+// capacity. It is solved primal-dual: a Dijkstra on reduced costs from all
+// sites with waiting patients updates the node potentials, then a
+// Dinic-style blocking flow saturates every shortest route (arcs of zero
+// reduced cost) before the next Dijkstra. Patients are node supplies rather
+// than arcs out of a source, so new arrivals change no residual arc and the
+// potentials stay valid: a solved incident is extended by continuing from its
+// current flow, rerouting earlier patients where that lowers the total.
+const long long FLOW_INF = numeric_limits<long long>::max() / 4;
+
+struct CasualtyFlow {
+    long long version = -1; // networkVersion the arrays were built for
+    vector<int> capacity;   // Center capacity per node, 0 without a center
+    vector<int> cost;       // Metres per CSR arc
+    vector<int> twin;       // CSR index of each arc's reverse
+    vector<int> flow;       // Patients routed along each arc
+    vector<int> supply;     // Patients at each node still to be placed
+    vector<int> placed;     // Patients from each node already placed
+    vector<int> admitted;   // Patients sent to each node's center
+    vector<int> sites;      // Nodes that have had patients
+    vector<long long> potential;
+    long long sinkPotential = 0;
+    vector<long long> dist;
+    vector<int> level, nextArc, order, arcs;
+};
+
+struct CasualtyAssignment {
+    int site, center, patients;
+    float km; // Road distance per patient
+};
+
+// Starts an empty incident on g with the current center capacities.
+void resetCasualtyFlow(CasualtyFlow& cf, const CSRGraph& g) {
+    ensureAdjacency();
+    int n = g.numNodes(), m = g.numEdges();
+    cf = CasualtyFlow();
+    cf.version = networkVersion;
+    cf.capacity.assign(n, 0);
+    for (const auto& hc : centers) cf.capacity[hc.node] = max(0, hc.capacity);
+    cf.cost.resize(m);
+    cf.twin.resize(m);
+    for (int u = 0; u < n; ++u) {
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            cf.cost[e] = (int)lround(g.weights[e] * 1000);
+            cf.twin[e] = g.offsets[g.targets[e]] + adjList[u][e - g.offsets[u]].twin;
+        }
+    }
+    cf.flow.assign(m, 0);
+    cf.supply.assign(n, 0);
+    cf.placed.assign(n, 0);
+    cf.admitted.assign(n, 0);
+    cf.potential.assign(n, 0);
+    cf.level.assign(n, -1);
+    cf.nextArc.assign(n, 0);
+}
+
+void addCasualties(CasualtyFlow& cf, int node, int patients) {
+    if (patients <= 0) return;
+    if (cf.supply[node] == 0 && cf.placed[node] == 0) cf.sites.push_back(node);
+    cf.supply[node] += patients;
+}
+
+// Reduced costs of moving a patient along arc e out of u: cancelling flow
+// that runs the other way (only while there is some) or adding new flow.
+long long cancelReducedCost(const CasualtyFlow& cf, const CSRGraph& g, int u, int e) {
+    return -cf.cost[e] + cf.potential[u] - cf.potential[g.targets[e]];
+}
+
+long long forwardReducedCost(const CasualtyFlow& cf, const CSRGraph& g, int u, int e) {
+    return cf.cost[e] + cf.potential[u] - cf.potential[g.targets[e]];
+}
+
+// Spare capacity of arc e among zero-reduced-cost arcs, 0 if not admissible.
+long long admissibleCapacity(const CasualtyFlow& cf, const CSRGraph& g, int u, int e) {
+    if (forwardReducedCost(cf, g, u, e) == 0) return FLOW_INF;
+    if (cf.flow[cf.twin[e]] > 0 && cancelReducedCost(cf, g, u, e) == 0) return cf.flow[cf.twin[e]];
+    return 0;
+}
+
+bool sinkAdmissible(const CasualtyFlow& cf, int u) {
+    return cf.admitted[u] < cf.capacity[u] && cf.potential[u] == cf.sinkPotential;
+}
+
+// Dijkstra on reduced costs from the super-source, stopped once the
+// super-sink is settled. Unsettled nodes are charged the sink distance, which
+// keeps every residual reduced cost non-negative. Returns false when no site
+// can reach a center with room left.
+bool updateCasualtyPotentials(CasualtyFlow& cf, const CSRGraph& g) {
+    cf.dist.assign(g.numNodes(), FLOW_INF);
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> pq;
+    for (int s : cf.sites) {
+        if (cf.supply[s] > 0) {
+            cf.dist[s] = 0;
+            pq.push({0, s});
+        }
+    }
+    long long sinkDist = FLOW_INF;
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > cf.dist[u]) continue;
+        if (d >= sinkDist) break;
+        if (cf.admitted[u] < cf.capacity[u]) sinkDist = min(sinkDist, d + cf.potential[u] - cf.sinkPotential);
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            long long rc = cf.flow[cf.twin[e]] > 0 ? cancelReducedCost(cf, g, u, e) : forwardReducedCost(cf, g, u, e);
+            int v = g.targets[e];
+            if (d + rc < cf.dist[v]) {
+                cf.dist[v] = d + rc;
+                pq.push({cf.dist[v], v});
+            }
+        }
+    }
+    if (sinkDist == FLOW_INF) return false;
+    for (int v = 0; v < g.numNodes(); ++v) cf.potential[v] += min(cf.dist[v], sinkDist);
+    cf.sinkPotential += sinkDist;
+    return true;
+}
+
+// Dinic phase on the zero-reduced-cost arcs: BFS levels from the sites, then
+// repeated path searches with per-node arc cursors until the level graph is
+// blocked. Returns the number of patients placed.
+long long casualtyBlockingFlow(CasualtyFlow& cf, const CSRGraph& g) {
+    long long placed = 0;
+    while (true) {
+        fill(cf.level.begin(), cf.level.end(), -1);
+        vector<int>& queue = cf.order;
+        queue.clear();
+        for (int s : cf.sites) {
+            if (cf.supply[s] > 0) {
+                cf.level[s] = 0;
+                queue.push_back(s);
+            }
+        }
+        int sinkLevel = -1; // Level of the nodes that drain into the sink
+        for (size_t head = 0; head < queue.size(); ++head) {
+            int u = queue[head];
+            if (sinkLevel >= 0 && cf.level[u] >= sinkLevel) break;
+            if (sinkAdmissible(cf, u)) {
+                sinkLevel = cf.level[u];
+                continue;
+            }
+            for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                int v = g.targets[e];
+                if (cf.level[v] < 0 && admissibleCapacity(cf, g, u, e) > 0) {
+                    cf.level[v] = cf.level[u] + 1;
+                    queue.push_back(v);
+                }
+            }
+        }
+        if (sinkLevel < 0) return placed;
+
+        for (int u : queue) cf.nextArc[u] = g.offsets[u];
+        vector<int>& arcs = cf.arcs;
+        for (int s : queue) {
+            if (cf.level[s] != 0) continue;
+            while (cf.supply[s] > 0) {
+                arcs.clear();
+                int u = s;
+                while (!(cf.level[u] == sinkLevel && sinkAdmissible(cf, u))) {
+                    int& e = cf.nextArc[u];
+                    if (cf.level[u] < sinkLevel) {
+                        for (; e < g.offsets[u + 1]; ++e) {
+                            int v = g.targets[e];
+                            if (cf.level[v] == cf.level[u] + 1 && admissibleCapacity(cf, g, u, e) > 0) break;
+                        }
+                    }
+                    if (cf.level[u] < sinkLevel && e < g.offsets[u + 1]) {
+                        arcs.push_back(e);
+                        u = g.targets[e];
+                        continue;
+                    }
+                    cf.level[u] = -1; // Dead end for the rest of this phase
+                    if (arcs.empty()) break;
+                    arcs.pop_back();
+                    u = arcs.empty() ? s : g.targets[arcs.back()];
+                    ++cf.nextArc[u];
+                }
+                if (cf.level[u] != sinkLevel) break;
+                long long push = min<long long>(cf.supply[s], cf.capacity[u] - cf.admitted[u]);
+                int from = s;
+                for (int e : arcs) {
+                    push = min(push, admissibleCapacity(cf, g, from, e));
+                    from = g.targets[e];
+                }
+                from = s;
+                for (int e : arcs) {
+                    int cancel = cancelReducedCost(cf, g, from, e) == 0 ? (int)min<long long>(push, cf.flow[cf.twin[e]]) : 0;
+                    cf.flow[cf.twin[e]] -= cancel;
+                    cf.flow[e] += (int)push - cancel;
+                    from = g.targets[e];
+                }
+                cf.supply[s] -= push;
+                cf.placed[s] += push;
+                cf.admitted[u] += push;
+                placed += push;
+            }
+        }
+    }
+}
+
+// Places as many waiting patients as capacity and connectivity allow.
+// Returns the number placed by this call.
+long long solveCasualtyFlow(CasualtyFlow& cf, const CSRGraph& g) {
+    long long placed = 0;
+    while (updateCasualtyPotentials(cf, g)) placed += casualtyBlockingFlow(cf, g);
+    return placed;
+}
+
+long long casualtyCostMetres(const CasualtyFlow& cf) {
+    long long total = 0;
+    for (size_t e = 0; e < cf.flow.size(); ++e) total += (long long)cf.flow[e] * cf.cost[e];
+    return total;
+}
+
+// Splits the flow into site -> center routes by following arcs that carry
+// patients; any zero-length cycle met on the way is cancelled first.
+vector<CasualtyAssignment> casualtyAssignments(const CasualtyFlow& cf, const CSRGraph& g) {
+    vector<int> flow = cf.flow, admitted = cf.admitted, cursor(g.offsets.begin(), g.offsets.end() - 1);
+    vector<int> onPath(g.numNodes(), -1);
+    vector<CasualtyAssignment> result;
+    vector<int> nodes, arcs;
+    for (int s : cf.sites) {
+        int left = cf.placed[s];
+        while (left > 0) {
+            nodes.assign(1, s);
+            arcs.clear();
+            onPath[s] = 0;
+            int u = s;
+            while (admitted[u] == 0) {
+                int& e = cursor[u];
+                while (flow[e] == 0) ++e;
+                int v = g.targets[e];
+                if (onPath[v] >= 0) {
+                    int cut = onPath[v], least = flow[e];
+                    for (size_t i = cut; i < arcs.size(); ++i) least = min(least, flow[arcs[i]]);
+                    flow[e] -= least;
+                    for (size_t i = cut; i < arcs.size(); ++i) flow[arcs[i]] -= least;
+                    for (size_t i = cut + 1; i < nodes.size(); ++i) onPath[nodes[i]] = -1;
+                    nodes.resize(cut + 1);
+                    arcs.resize(cut);
+                    u = v;
+                    continue;
+                }
+                arcs.push_back(e);
+                onPath[v] = nodes.size();
+                nodes.push_back(v);
+                u = v;
+            }
+            int patients = min(left, admitted[u]);
+            float km = 0;
+            for (int e : arcs) {
+                patients = min(patients, flow[e]);
+                km += g.weights[e];
+            }
+            for (int e : arcs) flow[e] -= patients;
+            admitted[u] -= patients;
+            left -= patients;
+            result.push_back({s, u, patients, km});
+            for (int v : nodes) onPath[v] = -1;
+        }
+    }
+    return result;
+}
+
+CasualtyFlow incident;
+vector<pair<CenterId, int>> incidentPatients; // Every site and count entered so far
+
+// Adds patients to the current incident and re-solves from the previous
+// flow. Placed patients may be rerouted but keep a bed when beds run short.
+// The incident is rebuilt from scratch after the network or a capacity
+// changes.
+void massCasualtyAssignment(const vector<pair<CenterId, int>>& arrivals) {
+    const CSRGraph& g = graph();
+    bool rebuild = incident.version != networkVersion;
+    for (const auto& hc : centers) {
+        if (!rebuild && incident.capacity[hc.node] != max(0, hc.capacity)) rebuild = true;
+    }
+    vector<pair<int, int>> added;
+    for (const auto& arrival : arrivals) {
+        int node = queryNode(arrival.first);
+        if (node < 0 || arrival.second <= 0) {
+            cout << "Skipping invalid entry " << arrival.first << " " << arrival.second << ".\n";
+            continue;
+        }
+        incidentPatients.push_back(arrival);
+        added.push_back({node, arrival.second});
+    }
+    if (rebuild) {
+        resetCasualtyFlow(incident, g);
+        added.clear();
+        for (const auto& entry : incidentPatients) {
+            int node = queryNode(entry.first);
+            if (node >= 0) added.push_back({node, entry.second});
+        }
+    }
+    for (const auto& entry : added) addCasualties(incident, entry.first, entry.second);
+    solveCasualtyFlow(incident, g);
+
+    long long total = 0, waiting = 0;
+    for (int s : incident.sites) {
+        total += incident.supply[s] + incident.placed[s];
+        waiting += incident.supply[s];
+    }
+    vector<CasualtyAssignment> routes = casualtyAssignments(incident, g);
+    sort(routes.begin(), routes.end(), [](const CasualtyAssignment& a, const CasualtyAssignment& b) {
+        return make_pair(a.site, a.km) < make_pair(b.site, b.km);
+    });
+    for (const auto& r : routes) {
+        cout << r.patients << " patient(s) from " << idOf(r.site) << " to " << idOf(r.center) << ": " << r.km << " km\n";
+    }
+    cout << "Placed " << total - waiting << " of " << total << " patients, " << casualtyCostMetres(incident) / 1000.0
+         << " patient-km in total.\n";
+    if (waiting) cout << waiting << " patient(s) could not be placed: no reachable center has room.\n";
+}
+
+void clearIncident() {
+    incident = CasualtyFlow();
+    incidentPatients.clear();
+    cout << "Mass-casualty incident cleared.\n";
+}
+
+// Contraction hierarchy
+// Nodes are contracted one at a time in order of edge difference; whenever the
+// only shortest path between two neighbours runs through the contracted node
+// a shortcut is added. Every arc kept at contraction time points from a node
+// to a higher-ranked one, so both directions of a query run upward over the
+// same arrays. Shortcuts remember their middle node for path unpacking.
+struct ContractionHierarchy {
+    vector<int> rank;
+    vector<int> upOffsets;
+    vector<int> upTargets;
+    vector<float> upWeights;
+    vector<int> upMiddle; // -1 for original connections
+    uint64_t fingerprint = 0;
+
+    int numNodes() const { return (int)rank.size(); }
+};
+
+struct CHArc {
+    int to;
+    float weight;
+    int middle;
+};
+
+const int CH_WITNESS_SETTLE_LIMIT = 500;
+const char CH_MAGIC[4] = {'H', 'C', 'C', 'H'};
+const uint32_t CH_VERSION = 1;
+
+ContractionHierarchy contractionHierarchy;
+long long chNetworkVersion = -1; // networkVersion the in-memory hierarchy matches
+
+// Scratch space for the bounded witness searches, reset through a touched list.
+struct WitnessSearch {
+    vector<float> dist;
+    vector<int> touched;
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
+
+    explicit WitnessSearch(int n) : dist(n, INF) {}
+
+    // Distances from source in the remaining graph without node skip, limited
+    // to maxDist and CH_WITNESS_SETTLE_LIMIT settled nodes.
+    void run(const vector<vector<CHArc>>& adj, const vector<bool>& contracted, int source, int skip, float maxDist) {
+        for (int v : touched) dist[v] = INF;
+        touched.clear();
+        pq = {};
+        dist[source] = 0;
+        touched.push_back(source);
+        pq.push({0, source});
+        int settled = 0;
+        while (!pq.empty() && settled < CH_WITNESS_SETTLE_LIMIT) {
+            float d = pq.top().first;
+            int u = pq.top().second;
+            pq.pop();
+            if (d > dist[u]) continue;
+            if (d > maxDist) break;
+            ++settled;
+            for (const auto& a : adj[u]) {
+                if (a.to == skip || contracted[a.to]) continue;
+                if (d + a.weight < dist[a.to]) {
+                    if (dist[a.to] == INF) touched.push_back(a.to);
+                    dist[a.to] = d + a.weight;
+                    pq.push({dist[a.to], a.to});
+                }
+            }
+        }
+    }
+};
+
+// Finds the shortcuts contracting v would need. Each pair of remaining
+// neighbours is reported once, as (neighbour index, neighbour index, weight).
+void findShortcuts(const vector<vector<CHArc>>& adj, const vector<bool>& contracted, int v,
+                   WitnessSearch& witness, vector<tuple<int, int, float>>& shortcuts) {
+    shortcuts.clear();
+    const auto& arcs = adj[v];
+    float maxOut = 0;
+    for (const auto& a : arcs) maxOut = max(maxOut, a.weight);
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (contracted[arcs[i].to]) continue;
+        witness.run(adj, contracted, arcs[i].to, v, arcs[i].weight + maxOut);
+        for (size_t j = i + 1; j < arcs.size(); ++j) {
+            if (contracted[arcs[j].to] || arcs[j].to == arcs[i].to) continue;
+            float via = arcs[i].weight + arcs[j].weight;
+            if (witness.dist[arcs[j].to] > via) shortcuts.emplace_back((int)i, (int)j, via);
+        }
+    }
+}
+
+void addOrLowerArc(vector<CHArc>& arcs, int to, float weight, int middle) {
+    for (auto& a : arcs) {
+        if (a.to == to) {
+            if (weight < a.weight) a = {to, weight, middle};
+            return;
+        }
+    }
+    arcs.push_back({to, weight, middle});
+}
+
+void buildContractionHierarchy(const CSRGraph& g, ContractionHierarchy& ch) {
+    int n = g.numNodes();
+    vector<vector<CHArc>> adj(n);
+    for (int u = 0; u < n; ++u) {
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            if (g.targets[e] != u) addOrLowerArc(adj[u], g.targets[e], g.weights[e], -1);
+        }
+    }
+
+    vector<bool> contracted(n, false);
+    vector<int> deletedNeighbors(n, 0);
+    WitnessSearch witness(n);
+    vector<tuple<int, int, float>> shortcuts;
+    auto priority = [&](int v) {
+        int live = 0;
+        for (const auto& a : adj[v]) live += !contracted[a.to];
+        findShortcuts(adj, contracted, v, witness, shortcuts);
+        return (int)shortcuts.size() - live + deletedNeighbors[v];
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<>> order;
+    for (int v = 0; v < n; ++v) order.push({priority(v), v});
+
+    ch.rank.assign(n, -1);
+    vector<vector<CHArc>> up(n);
+    int nextRank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+        if (contracted[v]) continue;
+        // Lazy update: re-evaluate and put v back if it is no longer the best.
+        int current = priority(v);
+        if (!order.empty() && current > order.top().first) {
+            order.push({current, v});
+            continue;
+        }
+
+        findShortcuts(adj, contracted, v, witness, shortcuts);
+        for (const auto& sc : shortcuts) {
+            int a = adj[v][get<0>(sc)].to, b = adj[v][get<1>(sc)].to;
+            addOrLowerArc(adj[a], b, get<2>(sc), v);
+            addOrLowerArc(adj[b], a, get<2>(sc), v);
+        }
+        for (const auto& a : adj[v]) {
+            if (contracted[a.to]) continue;
+            up[v].push_back(a);
+            ++deletedNeighbors[a.to];
+        }
+        contracted[v] = true;
+        ch.rank[v] = nextRank++;
+        vector<CHArc>().swap(adj[v]);
+    }
+
+    ch.upOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) ch.upOffsets[v + 1] = ch.upOffsets[v] + (int)up[v].size();
+    ch.upTargets.clear();
+    ch.upWeights.clear();
+    ch.upMiddle.clear();
+    for (int v = 0; v < n; ++v) {
+        for (const auto& a : up[v]) {
+            ch.upTargets.push_back(a.to);
+            ch.upWeights.push_back(a.weight);
+            ch.upMiddle.push_back(a.middle);
+        }
+    }
+    ch.fingerprint = networkFingerprint(g);
+}
+
+void saveContractionHierarchy(const ContractionHierarchy& ch, const string& filename) {
+    ofstream out(filename, ios::binary);
+    out.write(CH_MAGIC, 4);
+    writePod(out, CH_VERSION);
+    writePod(out, ch.fingerprint);
+    writeArray(out, ch.rank);
+    writeArray(out, ch.upOffsets);
+    writeArray(out, ch.upTargets);
+    writeArray(out, ch.upWeights);
+    writeArray(out, ch.upMiddle);
+}
+
+// Fails unless the saved hierarchy matches the network and is well formed:
+// ranks a permutation of the n nodes, upward offsets non-decreasing from 0 to
+// the arc count, and every target and middle node in range.
+bool loadContractionHierarchy(ContractionHierarchy& ch, const string& filename, uint64_t expectedFingerprint, int numNodes) {
+    ifstream in(filename, ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t fingerprint;
+    if (!in.read(magic, 4) || !equal(magic, magic + 4, CH_MAGIC)) return false;
+    if (!readPod(in, version) || version != CH_VERSION) return false;
+    if (!readPod(in, fingerprint) || fingerprint != expectedFingerprint) return false;
+    ch.fingerprint = fingerprint;
+    if (!readArray(in, ch.rank) || !readArray(in, ch.upOffsets) || !readArray(in, ch.upTargets) ||
+        !readArray(in, ch.upWeights) || !readArray(in, ch.upMiddle)) {
+        return false;
+    }
+    int n = numNodes;
+    size_t arcs = ch.upTargets.size();
+    if ((int)ch.rank.size() != n || (int)ch.upOffsets.size() != n + 1 || ch.upOffsets[0] != 0 ||
+        (size_t)ch.upOffsets[n] != arcs || ch.upWeights.size() != arcs || ch.upMiddle.size() != arcs) {
+        return false;
+    }
+    vector<char> ranked(n, 0);
+    for (int v = 0; v < n; ++v) {
+        int r = ch.rank[v];
+        if (r < 0 || r >= n || ranked[r] || ch.upOffsets[v] > ch.upOffsets[v + 1]) return false;
+        ranked[r] = 1;
+    }
+    for (size_t e = 0; e < arcs; ++e) {
+        if (ch.upTargets[e] < 0 || ch.upTargets[e] >= n || ch.upMiddle[e] < -1 || ch.upMiddle[e] >= n) return false;
+    }
+    return true;
+}
+
+// Returns a hierarchy for the current network, loading it from filename when
+// the saved one matches and otherwise building and saving a fresh one.
+const ContractionHierarchy& currentContractionHierarchy(const string& filename) {
+    const CSRGraph& g = graph();
+    if (chNetworkVersion == networkVersion) return contractionHierarchy;
+    uint64_t fingerprint = networkFingerprint(g);
+    if (!loadContractionHierarchy(contractionHierarchy, filename, fingerprint, g.numNodes())) {
+        cout << "Building contraction hierarchy...\n";
+        buildContractionHierarchy(g, contractionHierarchy);
+        saveContractionHierarchy(contractionHierarchy, filename);
+    }
+    chNetworkVersion = networkVersion;
+    return contractionHierarchy;
+}
+
+// Per-query state for the bidirectional upward search.
+struct CHQuerySpace {
+    vector<float> dist[2];
+    vector<int> parentArc[2]; // Index into the up arrays of the arc used to reach each node
+    vector<int> touched;
+
+    void prepare(int n) {
+        for (int side = 0; side < 2; ++side) {
+            if ((int)dist[side].size() < n) {
+                dist[side].assign(n, INF);
+                parentArc[side].assign(n, -1);
+            }
+        }
+        for (int v : touched) {
+            dist[0][v] = dist[1][v] = INF;
+            parentArc[0][v] = parentArc[1][v] = -1;
+        }
+        touched.clear();
+    }
+};
+
+// Appends the original nodes along up-arc e from its lower end `from` to its
+// upper end, excluding `from` itself.
+void unpackArc(const ContractionHierarchy& ch, int from, int e, vector<int>& path) {
+    // Segments (a, b, middle) still to expand, last one first in travel order.
+    vector<tuple<int, int, int>> stack = {{from, ch.upTargets[e], ch.upMiddle[e]}};
+    while (!stack.empty()) {
+        int a = get<0>(stack.back()), b = get<1>(stack.back()), m = get<2>(stack.back());
+        stack.pop_back();
+        if (m == -1) {
+            path.push_back(b);
+            continue;
+        }
+        // Both halves of a shortcut were recorded at its middle node, which
+        // was contracted before either end.
+        int middleToA = -1, middleToB = -1;
+        for (int k = ch.upOffsets[m]; k < ch.upOffsets[m + 1]; ++k) {
+            if (ch.upTargets[k] == a) middleToA = ch.upMiddle[k];
+            if (ch.upTargets[k] == b) middleToB = ch.upMiddle[k];
+        }
+        stack.push_back({m, b, middleToB});
+        stack.push_back({a, m, middleToA});
+    }
+}
+
+// Bidirectional upward Dijkstra from start and end. Returns the distance and
+// fills path with the unpacked original nodes, or returns INF.
+float contractionHierarchyQuery(const ContractionHierarchy& ch, int start, int end, CHQuerySpace& space, vector<int>& path) {
+    path.clear();
+    space.prepare(ch.numNodes());
+    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq[2];
+    int source[2] = {start, end};
+    for (int side = 0; side < 2; ++side) {
+        space.dist[side][source[side]] = 0;
+        space.touched.push_back(source[side]);
+        pq[side].push({0, source[side]});
+    }
+
+    float best = INF;
+    int meet = -1;
+    while (!pq[0].empty() || !pq[1].empty()) {
+        float top0 = pq[0].empty() ? INF : pq[0].top().first;
+        float top1 = pq[1].empty() ? INF : pq[1].top().first;
+        if (min(top0, top1) >= best) break;
+        int side = top0 <= top1 ? 0 : 1;
+        float d = pq[side].top().first;
+        int u = pq[side].top().second;
+        pq[side].pop();
+        if (d > space.dist[side][u]) continue;
+        if (space.dist[1 - side][u] < INF && d + space.dist[1 - side][u] < best) {
+            best = d + space.dist[1 - side][u];
+            meet = u;
+        }
+        for (int e = ch.upOffsets[u]; e < ch.upOffsets[u + 1]; ++e) {
+            int v = ch.upTargets[e];
+            if (d + ch.upWeights[e] < space.dist[side][v]) {
+                if (space.dist[0][v] == INF && space.dist[1][v] == INF) space.touched.push_back(v);
+                space.dist[side][v] = d + ch.upWeights[e];
+                space.parentArc[side][v] = e;
+                pq[side].push({space.dist[side][v], v});
+            }
+        }
+    }
+    if (meet == -1) return INF;
+
+    // Collect the upward arcs on each side, then unpack them in travel order.
+    auto arcSource = [&](int e) {
+        return (int)(upper_bound(ch.upOffsets.begin(), ch.upOffsets.end(), e) - ch.upOffsets.begin()) - 1;
+    };
+    vector<int> forwardArcs;
+    for (int v = meet; v != start; v = arcSource(space.parentArc[0][v])) forwardArcs.push_back(space.parentArc[0][v]);
+    path.push_back(start);
+    for (int i = (int)forwardArcs.size() - 1; i >= 0; --i) unpackArc(ch, arcSource(forwardArcs[i]), forwardArcs[i], path);
+    for (int v = meet; v != end; ) {
+        int e = space.parentArc[1][v];
+        int lower = arcSource(e);
+        // Walk the arc downward: unpack it upward into a buffer and reverse.
+        vector<int> segment = {lower};
+        unpackArc(ch, lower, e, segment);
+        for (int i = (int)segment.size() - 2; i >= 0; --i) path.push_back(segment[i]);
+        v = lower;
+    }
+
+    // Re-add the original edge weights in travel order so the distance is the
+    // exact float sum Dijkstra produces along the same path.
+    const CSRGraph& g = network;
+    float total = 0;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        float w = INF;
+        for (int e = g.offsets[path[i]]; e < g.offsets[path[i] + 1]; ++e) {
+            if (g.targets[e] == path[i + 1]) w = min(w, g.weights[e]);
+        }
+        total += w;
+    }
+    return total;
+}
+
+CHQuerySpace chQuerySpace;
+
+void contractionHierarchyRoute(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    const ContractionHierarchy& ch = currentContractionHierarchy("connections.ch");
+    vector<int> path;
+    float d = contractionHierarchyQuery(ch, start, end, chQuerySpace, path);
+    if (d == INF) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    cout << "Shortest Distance from " << startId << " to " << endId << ": " << d << " km\n";
+    cout << "Path: ";
+    for (size_t i = 0; i < path.size(); ++i) cout << idOf(path[i]) << (i + 1 < path.size() ? " -> " : "\n");
+}
+
+// Hub labels
+// Pruned landmark labeling: every node keeps a label of (hub, distance) pairs
+// such that any two nodes share a hub on one of their shortest paths, so a
+// distance is the best sum over the hubs their labels have in common. Hubs
+// are taken in contraction hierarchy order, most important first, and each
+// one runs a Dijkstra that stops expanding wherever the labels built so far
+// already give the distance. Hubs are stored by that order, so every label
+// comes out sorted; labels sit back to back in flat arrays, each padded to a
+// multiple of four entries so the intersection can compare four hubs of one
+// label with four of the other per step.
+struct HubLabels {
+    vector<int> offsets;   // Label of node v is [offsets[v], offsets[v + 1])
+    vector<uint32_t> hubs; // Hub order position, ascending within a label
+    vector<float> dists;
+    uint64_t fingerprint = 0;
+
+    int numNodes() const { return (int)offsets.size() - 1; }
+};
+
+const uint32_t HUB_PAD = numeric_limits<uint32_t>::max();
+const char HL_MAGIC[4] = {'H', 'C', 'H', 'L'};
+const uint32_t HL_VERSION = 1;
+
+HubLabels hubLabels;
+long long hlNetworkVersion = -1; // networkVersion the in-memory labels match
+
+void buildHubLabels(const CSRGraph& g, const ContractionHierarchy& ch, HubLabels& hl) {
+    int n = g.numNodes();
+    vector<int> order(n);
+    for (int v = 0; v < n; ++v) order[n - 1 - ch.rank[v]] = v;
+    vector<vector<pair<uint32_t, float>>> labels(n);
+    vector<float> hubDist(n, INF); // Distances from the current hub, by hub position
+    QueryContext qc;
+    for (int i = 0; i < n; ++i) {
+        int h = order[i];
+        for (const auto& [hub, d] : labels[h]) hubDist[hub] = d;
+        qc.begin(n);
+        qc.pq.reset(n);
+        qc.reach(h, 0, -1);
+        qc.pq.push(h, 0);
+        while (!qc.pq.empty()) {
+            auto [d, u] = qc.pq.pop();
+            if (d > qc.dist[u]) continue;
+            float known = INF;
+            for (const auto& [hub, du] : labels[u]) known = min(known, hubDist[hub] + du);
+            if (known <= d) continue;
+            labels[u].push_back({(uint32_t)i, d});
+            for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                int v = g.targets[e];
+                if (!qc.reached(v) || d + g.weights[e] < qc.dist[v]) {
+                    qc.reach(v, d + g.weights[e], u);
+                    qc.pq.push(v, d + g.weights[e]);
+                }
+            }
+        }
+        for (const auto& entry : labels[h]) hubDist[entry.first] = INF;
+    }
+
+    hl.offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) hl.offsets[v + 1] = hl.offsets[v] + (int)(labels[v].size() + 3) / 4 * 4;
+    hl.hubs.assign(hl.offsets[n], HUB_PAD);
+    hl.dists.assign(hl.offsets[n], INF);
+    for (int v = 0; v < n; ++v) {
+        for (size_t k = 0; k < labels[v].size(); ++k) {
+            hl.hubs[hl.offsets[v] + k] = labels[v][k].first;
+            hl.dists[hl.offsets[v] + k] = labels[v][k].second;
+        }
+        vector<pair<uint32_t, float>>().swap(labels[v]);
+    }
+    hl.fingerprint = networkFingerprint(g);
+}
+
+// Merge of two sorted labels, one entry at a time.
+float hubDistanceScalar(const HubLabels& hl, int a, int b) {
+    int i = hl.offsets[a], j = hl.offsets[b], endA = hl.offsets[a + 1], endB = hl.offsets[b + 1];
+    float best = INF;
+    while (i < endA && j < endB && hl.hubs[i] != HUB_PAD && hl.hubs[j] != HUB_PAD) {
+        if (hl.hubs[i] < hl.hubs[j]) {
+            ++i;
+        } else if (hl.hubs[i] > hl.hubs[j]) {
+            ++j;
+        } else {
+            best = min(best, hl.dists[i++] + hl.dists[j++]);
+        }
+    }
+    return best;
+}
+
+#if defined(HAVE_X86_SIMD) && defined(__SSE2__)
+// Compares a block of four hubs from each label under all four rotations of
+// the second block, then steps past whichever block ends lower (both when
+// they end on the same hub). Padding pairs up only with padding, at twice INF.
+float hubDistanceSse2(const HubLabels& hl, int a, int b) {
+    const uint32_t* hubsA = hl.hubs.data() + hl.offsets[a];
+    const uint32_t* hubsB = hl.hubs.data() + hl.offsets[b];
+    const float* distsA = hl.dists.data() + hl.offsets[a];
+    const float* distsB = hl.dists.data() + hl.offsets[b];
+    int lenA = hl.offsets[a + 1] - hl.offsets[a], lenB = hl.offsets[b + 1] - hl.offsets[b];
+    const __m128 inf = _mm_set1_ps(INF);
+    __m128 best = inf;
+    int i = 0, j = 0;
+    while (i < lenA && j < lenB) {
+        __m128i ha = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hubsA + i));
+        __m128i hb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hubsB + j));
+        __m128 da = _mm_loadu_ps(distsA + i), db = _mm_loadu_ps(distsB + j);
+        for (int rotation = 0; rotation < 4; ++rotation) {
+            __m128 match = _mm_castsi128_ps(_mm_cmpeq_epi32(ha, hb));
+            __m128 sum = _mm_add_ps(da, db);
+            best = _mm_min_ps(best, _mm_or_ps(_mm_and_ps(match, sum), _mm_andnot_ps(match, inf)));
+            hb = _mm_shuffle_epi32(hb, _MM_SHUFFLE(0, 3, 2, 1));
+            db = _mm_shuffle_ps(db, db, _MM_SHUFFLE(0, 3, 2, 1));
+        }
+        uint32_t lastA = hubsA[i + 3], lastB = hubsB[j + 3];
+        if (lastA <= lastB) i += 4;
+        if (lastB <= lastA) j += 4;
+    }
+    best = _mm_min_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_min_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+    return min(INF, _mm_cvtss_f32(best));
+}
+#endif
+
+// Distance between a and b, INF when they are not connected.
+float hubDistance(const HubLabels& hl, int a, int b) {
+#if defined(HAVE_X86_SIMD) && defined(__SSE2__)
+    return hubDistanceSse2(hl, a, b);
+#else
+    return hubDistanceScalar(hl, a, b);
+#endif
+}
+
+// Distances from source to each target. The source label is spread into a
+// table indexed by hub once, so each target costs one pass over its own label.
+void hubDistances(const HubLabels& hl, int source, const vector<int>& targets, vector<float>& out, vector<float>& table) {
+    if (table.size() < hl.offsets.size()) table.assign(hl.offsets.size(), INF);
+    int first = hl.offsets[source], last = hl.offsets[source + 1];
+    for (int k = first; k < last && hl.hubs[k] != HUB_PAD; ++k) table[hl.hubs[k]] = hl.dists[k];
+    out.resize(targets.size());
+    for (size_t t = 0; t < targets.size(); ++t) {
+        float best = INF;
+        for (int k = hl.offsets[targets[t]]; k < hl.offsets[targets[t] + 1] && hl.hubs[k] != HUB_PAD; ++k) {
+            best = min(best, table[hl.hubs[k]] + hl.dists[k]);
+        }
+        out[t] = min(best, INF);
+    }
+    for (int k = first; k < last && hl.hubs[k] != HUB_PAD; ++k) table[hl.hubs[k]] = INF;
+}
+
+void saveHubLabels(const HubLabels& hl, const string& filename) {
+    ofstream out(filename, ios::binary);
+    out.write(HL_MAGIC, 4);
+    writePod(out, HL_VERSION);
+    writePod(out, hl.fingerprint);
+    writeArray(out, hl.offsets);
+    writeArray(out, hl.hubs);
+    writeArray(out, hl.dists);
+}
+
+bool loadHubLabels(HubLabels& hl, const string& filename, uint64_t expectedFingerprint) {
+    ifstream in(filename, ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t fingerprint;
+    if (!in.read(magic, 4) || !equal(magic, magic + 4, HL_MAGIC)) return false;
+    if (!readPod(in, version) || version != HL_VERSION) return false;
+    if (!readPod(in, fingerprint) || fingerprint != expectedFingerprint) return false;
+    hl.fingerprint = fingerprint;
+    return readArray(in, hl.offsets) && readArray(in, hl.hubs) && readArray(in, hl.dists) &&
+           hl.hubs.size() == hl.dists.size() && !hl.offsets.empty() && (size_t)hl.offsets.back() == hl.hubs.size();
+}
+
+// Returns labels for the current network, loading them from filename when
+// the saved ones match and otherwise building (on the contraction hierarchy
+// order) and saving fresh ones.
+const HubLabels& currentHubLabels(const string& filename) {
+    const CSRGraph& g = graph();
+    if (hlNetworkVersion == networkVersion) return hubLabels;
+    uint64_t fingerprint = networkFingerprint(g);
+    if (!loadHubLabels(hubLabels, filename, fingerprint)) {
+        const ContractionHierarchy& ch = currentContractionHierarchy("connections.ch");
+        cout << "Building hub labels...\n";
+        buildHubLabels(g, ch, hubLabels);
+        saveHubLabels(hubLabels, filename);
+    }
+    hlNetworkVersion = networkVersion;
+    return hubLabels;
+}
+
+vector<float> hubTable; // Hub-indexed scratch for hubDistances
+
+// Road distance from one center to each candidate, nearest first. With no
+// candidates every other center is a candidate.
+void distancesToCandidates(CenterId startId, const vector<CenterId>& candidateIds) {
+    int start = queryNode(startId);
+    if (start < 0) {
+        cout << "Invalid health center ID.\n";
+        return;
+    }
+    vector<int> targets;
+    if (candidateIds.empty()) {
+        for (const auto& hc : centers) {
+            if (hc.node != start) targets.push_back(hc.node);
+        }
+    }
+    for (CenterId id : candidateIds) {
+        int node = queryNode(id);
+        if (node < 0) cout << "Skipping unknown ID " << id << ".\n";
+        else targets.push_back(node);
+    }
+    const HubLabels& hl = currentHubLabels("connections.hl");
+    vector<float> found;
+    // One candidate is a point query: intersecting the two labels beats
+    // spreading the start label into the hub table.
+    if (targets.size() == 1) found.assign(1, hubDistance(hl, start, targets[0]));
+    else hubDistances(hl, start, targets, found, hubTable);
+    vector<pair<float, int>> ranked;
+    for (size_t t = 0; t < targets.size(); ++t) ranked.push_back({found[t], targets[t]});
+    sort(ranked.begin(), ranked.end());
+    for (const auto& [d, node] : ranked) {
+        if (d == INF) cout << "ID " << idOf(node) << ": unreachable\n";
+        else cout << "ID " << idOf(node) << ": " << d << " km\n";
+    }
+}
+
+// Landmarks (ALT)
+// A few landmark centers keep their road distance to every node. By the
+// triangle inequality |d(L, t) - d(L, v)| never exceeds d(v, t), so the
+// largest such gap over the landmarks is a lower bound that A* can use in
+// place of the straight line; it follows the road network, so far fewer
+// nodes are settled. Landmarks are picked farthest-point (each new one is the
+// node farthest by road from those chosen so far, all within the component
+// of the first) or one per district (the member farthest from the centroid
+// of all centers, so other components can get one too). Distances are stored
+// node-major so one node's bounds sit together, and each query uses only the
+// few landmarks that bound it best. Once a table for the current network is
+// in memory or saved, the Dijkstra menu option and batch shortest queries
+// search with it as well.
+enum class LandmarkStrategy { Farthest, District };
+const char* const LANDMARK_STRATEGY_NAMES[] = {"farthest", "district"};
+const int DEFAULT_LANDMARKS = 16;
+const int ALT_ACTIVE_LANDMARKS = 4;
+const char ALT_MAGIC[4] = {'H', 'C', 'A', 'L'};
+const uint32_t ALT_VERSION = 1;
+
+struct LandmarkTable {
+    vector<int> landmarks;
+    vector<float> dist; // dist[v * landmarks.size() + i]: road distance from landmark i to v
+    uint64_t fingerprint = 0;
+
+    int count() const { return (int)landmarks.size(); }
+    float at(int v, int i) const { return dist[(size_t)v * landmarks.size() + i]; }
+};
+
+LandmarkTable landmarkTable;
+long long altNetworkVersion = -1; // networkVersion the in-memory table matches
+
+bool parseLandmarkStrategy(const string& name, LandmarkStrategy& strategy) {
+    for (int i = 0; i < 2; ++i) {
+        if (name == LANDMARK_STRATEGY_NAMES[i]) {
+            strategy = (LandmarkStrategy)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Farthest-point selection, starting from the node farthest from the best
+// connected center. The distance to the nearest landmark so far is kept up
+// to date by a Dijkstra from each new landmark that stops wherever an earlier
+// landmark is at least as close. Landmarks stay in the component of the
+// first; searches elsewhere fall back to plain Dijkstra.
+vector<int> farthestLandmarks(const CSRGraph& g, int count) {
+    int n = g.numNodes();
+    vector<int> chosen;
+    vector<float> nearest(n, INF);
+    QueryContext qc;
+    int next = 0;
+    for (int v = 0; v < n; ++v) {
+        if (g.degree(v) > g.degree(next)) next = v;
+    }
+    bool probe = true; // The first search only finds the first landmark
+    while ((int)chosen.size() < min(count, n)) {
+        if (!probe) chosen.push_back(next);
+        qc.begin(n);
+        qc.pq.reset(n);
+        qc.reach(next, 0, -1);
+        qc.pq.push(next, 0);
+        while (!qc.pq.empty()) {
+            auto [d, u] = qc.pq.pop();
+            if (d > qc.dist[u] || d >= nearest[u]) continue;
+            nearest[u] = d;
+            for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+                int v = g.targets[e];
+                float cost = d + g.weights[e];
+                if (cost < nearest[v] && (!qc.reached(v) || cost < qc.dist[v])) {
+                    qc.reach(v, cost, u);
+                    qc.pq.push(v, cost);
+                }
+            }
+        }
+        next = -1;
+        for (int v = 0; v < n; ++v) {
+            if (nearest[v] > 0 && nearest[v] < INF && (next < 0 || nearest[v] > nearest[next])) next = v;
+        }
+        if (next < 0) break;
+        if (probe) {
+            probe = false;
+            fill(nearest.begin(), nearest.end(), INF);
+        }
+    }
+    return chosen;
+}
+
+// One landmark per district, largest districts first: the member center
+// farthest from the centroid of all centers.
+vector<int> districtLandmarks(int count) {
+    if (centers.empty()) return {};
+    double lat = 0, lon = 0;
+    for (const auto& hc : centers) {
+        lat += hc.lat;
+        lon += hc.lon;
+    }
+    lat /= centers.size();
+    lon /= centers.size();
+    map<string, pair<int, pair<float, int>>> districts; // size, (distance, node) of the farthest member
+    for (const auto& hc : centers) {
+        auto& entry = districts[hc.district];
+        ++entry.first;
+        entry.second = max(entry.second, make_pair(haversineKm(hc.lat, hc.lon, (float)lat, (float)lon), hc.node));
+    }
+    vector<pair<int, int>> bySize;
+    for (const auto& entry : districts) bySize.push_back({-entry.second.first, entry.second.second.second});
+    sort(bySize.begin(), bySize.end());
+    vector<int> chosen;
+    for (int i = 0; i < min(count, (int)bySize.size()); ++i) chosen.push_back(bySize[i].second);
+    return chosen;
+}
+
+// Fills the table with a full Dijkstra from each landmark, one landmark per
+// pool task, then transposes the rows into node-major order.
+void buildLandmarkTable(const CSRGraph& g, const vector<int>& landmarks, LandmarkTable& table) {
+    int n = g.numNodes(), count = landmarks.size();
+    vector<vector<float>> rows(count);
+    workerPool().parallelFor(count, [&](size_t i, unsigned) {
+        vector<int> prev;
+        dijkstraSearch(g, landmarks[i], rows[i], prev);
+    });
+    table.landmarks = landmarks;
+    table.dist.resize((size_t)n * count);
+    for (int i = 0; i < count; ++i) {
+        for (int v = 0; v < n; ++v) table.dist[(size_t)v * count + i] = rows[i][v];
+        vector<float>().swap(rows[i]);
+    }
+    table.fingerprint = networkFingerprint(g);
+}
+
+// Landmarks giving the largest bounds between start and end, best first.
+void activeLandmarks(const LandmarkTable& table, int start, int end, vector<int>& active) {
+    vector<pair<float, int>> ranked;
+    for (int i = 0; i < table.count(); ++i) {
+        float a = table.at(start, i), b = table.at(end, i);
+        if (a < INF && b < INF) ranked.push_back({-fabs(a - b), i});
+    }
+    int take = min(ALT_ACTIVE_LANDMARKS, (int)ranked.size());
+    partial_sort(ranked.begin(), ranked.begin() + take, ranked.end());
+    active.clear();
+    for (int i = 0; i < take; ++i) active.push_back(ranked[i].second);
+}
+
+// A* from start to end on the landmark bounds. When some landmark reaches
+// only one of start and end they lie in different components and nothing is
+// searched. Returns the number of settled nodes; qc.distance(end) is INF when
+// end is unreachable.
+int altSearch(const CSRGraph& g, const LandmarkTable& table, int start, int end, QueryContext& qc, vector<int>& active) {
+    activeLandmarks(table, start, end, active);
+    int count = table.count();
+    const float* endRow = &table.dist[(size_t)end * count];
+    auto bound = [&](int v) {
+        float best = 0;
+        const float* row = &table.dist[(size_t)v * count];
+        for (int i : active) best = max(best, fabs(row[i] - endRow[i]));
+        return best;
+    };
+    auto apart = [&](int v) {
+        for (int i = 0; i < count; ++i) {
+            if ((table.at(v, i) == INF) != (endRow[i] == INF)) return true;
+        }
+        return false;
+    };
+    auto later = greater<pair<float, int>>();
+    qc.begin(g.numNodes());
+    qc.heap.clear();
+    if (apart(start)) return 0;
+    qc.reach(start, 0, -1);
+    qc.heap.push_back({bound(start), start});
+    int settled = 0;
+    while (!qc.heap.empty()) {
+        pop_heap(qc.heap.begin(), qc.heap.end(), later);
+        int u = qc.heap.back().second;
+        qc.heap.pop_back();
+        if (qc.settled(u)) continue;
+        qc.settle(u);
+        ++settled;
+        if (u == end) break;
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            float d = qc.dist[u] + g.weights[e];
+            if (!qc.settled(v) && (!qc.reached(v) || d < qc.dist[v])) {
+                qc.reach(v, d, u);
+                qc.heap.push_back({d + bound(v), v});
+                push_heap(qc.heap.begin(), qc.heap.end(), later);
+            }
+        }
+    }
+    return settled;
+}
+
+void saveLandmarkTable(const LandmarkTable& table, const string& filename) {
+    ofstream out(filename, ios::binary);
+    out.write(ALT_MAGIC, 4);
+    writePod(out, ALT_VERSION);
+    writePod(out, table.fingerprint);
+    writeArray(out, table.landmarks);
+    writeArray(out, table.dist);
+}
+
+bool loadLandmarkTable(LandmarkTable& table, const string& filename, uint64_t expectedFingerprint, int numNodes) {
+    ifstream in(filename, ios::binary);
+    char magic[4];
+    uint32_t version;
+    uint64_t fingerprint;
+    if (!in.read(magic, 4) || !equal(magic, magic + 4, ALT_MAGIC)) return false;
+    if (!readPod(in, version) || version != ALT_VERSION) return false;
+    if (!readPod(in, fingerprint) || fingerprint != expectedFingerprint) return false;
+    table.fingerprint = fingerprint;
+    return readArray(in, table.landmarks) && readArray(in, table.dist) &&
+           table.dist.size() == table.landmarks.size() * (size_t)numNodes;
+}
+
+// Picks landmarks with the given strategy, builds their table and saves it.
+const LandmarkTable& rebuildLandmarks(const string& filename, int count, LandmarkStrategy strategy) {
+    const CSRGraph& g = graph();
+    vector<int> chosen = strategy == LandmarkStrategy::Farthest ? farthestLandmarks(g, count) : districtLandmarks(count);
+    buildLandmarkTable(g, chosen, landmarkTable);
+    saveLandmarkTable(landmarkTable, filename);
+    altNetworkVersion = networkVersion;
+    return landmarkTable;
+}
+
+// Returns the table for the current network, loading it from filename when
+// the saved one matches and otherwise rebuilding it with the default
+// farthest-point landmarks.
+const LandmarkTable& currentLandmarks(const string& filename) {
+    const CSRGraph& g = graph();
+    if (altNetworkVersion == networkVersion) return landmarkTable;
+    if (loadLandmarkTable(landmarkTable, filename, networkFingerprint(g), g.numNodes())) {
+        altNetworkVersion = networkVersion;
+        return landmarkTable;
+    }
+    cout << "Building landmark table...\n";
+    return rebuildLandmarks(filename, DEFAULT_LANDMARKS, LandmarkStrategy::Farthest);
+}
+
+long long altProbedVersion = -1; // networkVersion filename was last checked for
+
+// The table for the current network if one is in memory or saved in
+// filename, without building one. A missing or stale file is only read
+// once per network version.
+const LandmarkTable* freshLandmarks(const string& filename) {
+    const CSRGraph& g = graph();
+    if (altNetworkVersion == networkVersion) return &landmarkTable;
+    if (altProbedVersion == networkVersion) return nullptr;
+    altProbedVersion = networkVersion;
+    if (!fileExists(filename) || !loadLandmarkTable(landmarkTable, filename, networkFingerprint(g), g.numNodes())) {
+        return nullptr;
+    }
+    altNetworkVersion = networkVersion;
+    return &landmarkTable;
+}
+
+void landmarkRoute(CenterId startId, CenterId endId) {
+    int start = queryNode(startId), end = queryNode(endId);
+    if (start < 0 || end < 0) {
+        cout << "Invalid health center ID(s).\n";
+        return;
+    }
+    const LandmarkTable& table = currentLandmarks("connections.alt");
+    QueryContext& qc = queryContext();
+    vector<int> active;
+    int settled = altSearch(graph(), table, start, end, qc, active);
+    if (qc.distance(end) == INF) {
+        cout << "No path from " << startId << " to " << endId << ".\n";
+        return;
+    }
+    cout << "Shortest Distance from " << startId << " to " << endId << ": " << qc.dist[end] << " km"
+         << " (" << settled << " centers settled)\n";
+    printPath(qc.prev, end);
+}
+
+// Isochrones
+// One Dijkstra on minutes serves every band: nodes are settled in time
+// order, so each falls into the first threshold at or above its travel time
+// and the search stops once it passes the largest threshold.
+const vector<int> DEFAULT_ISOCHRONE_MINUTES = {30, 60, 90};
+
+struct IsochroneBand {
+    int minutes;
+    vector<pair<int, int>> reached; // (node, minutes) newly reached in this band, nearest first
+};
+
+// Thresholds must be sorted ascending. Only nodes with a center record are
+// listed; callers refresh centerSlots first, since this runs on pool workers.
+void isochroneBands(const CSRGraph& g, int start, const vector<int>& thresholds, QueryContext& qc,
+                    vector<IsochroneBand>& bands) {
+    bands.resize(thresholds.size());
+    for (size_t b = 0; b < thresholds.size(); ++b) {
+        bands[b].minutes = thresholds[b];
+        bands[b].reached.clear();
+    }
+    if (thresholds.empty()) return;
+    float limit = thresholds.back();
+    qc.begin(g.numNodes());
+    qc.pq.reset(g.numNodes());
+    qc.reach(start, 0, -1);
+    qc.pq.push(start, 0);
+    size_t band = 0;
+    while (!qc.pq.empty()) {
+        auto [d, u] = qc.pq.pop();
+        if (d > qc.dist[u]) continue;
+        if (d > limit) break;
+        while (d > thresholds[band]) ++band;
+        if (hasCenterRecord(u)) bands[band].reached.push_back({u, (int)d});
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            float cost = d + g.times[e];
+            if (cost <= limit && (!qc.reached(v) || cost < qc.dist[v])) {
+                qc.reach(v, cost, u);
+                qc.pq.push(v, cost);
+            }
+        }
+    }
+}
+
+// Sorts and deduplicates thresholds, defaulting to 30/60/90 minutes.
+// Rejects negative minutes.
+bool normalizeThresholds(vector<int>& thresholds) {
+    if (thresholds.empty()) thresholds = DEFAULT_ISOCHRONE_MINUTES;
+    sort(thresholds.begin(), thresholds.end());
+    thresholds.erase(unique(thresholds.begin(), thresholds.end()), thresholds.end());
+    if (thresholds[0] < 0) {
+        cout << "Minutes must be non-negative.\n";
+        return false;
+    }
+    return true;
+}
+
+void isochrones(CenterId startId, vector<int> thresholds) {
+    int start = queryNode(startId);
+    if (start < 0) {
+        cout << "Invalid health center ID.\n";
+        return;
+    }
+    if (!normalizeThresholds(thresholds)) return;
+    refreshCenterSlots();
+    vector<IsochroneBand> bands;
+    isochroneBands(graph(), start, thresholds, queryContext(), bands);
+    int total = 0;
+    for (const auto& band : bands) {
+        total += band.reached.size();
+        cout << "Within " << band.minutes << " min (" << total << " centers):";
+        for (const auto& [node, minutes] : band.reached) cout << " " << idOf(node) << " (" << minutes << " min)";
+        cout << "\n";
+    }
+}
+
+// For every center, how many centers and beds lie within each threshold.
+// Searches run on the worker pool with one query context per worker; the
+// rows are written to filename in center order.
+void coverageTable(vector<int> thresholds, const string& filename) {
+    if (!normalizeThresholds(thresholds)) return;
+    const CSRGraph& g = graph();
+    refreshCenterSlots();
+    vector<int> beds(g.numNodes(), 0);
+    for (const auto& hc : centers) beds[hc.node] = max(0, hc.capacity);
+    size_t bands = thresholds.size();
+    vector<int> centerCounts(centers.size() * bands);
+    vector<long long> bedCounts(centers.size() * bands);
+    ThreadPool& pool = workerPool();
+    vector<QueryContext> contexts(pool.size());
+    vector<vector<IsochroneBand>> found(pool.size());
+    auto t0 = chrono::steady_clock::now();
+    pool.parallelFor(centers.size(), [&](size_t i, unsigned worker) {
+        isochroneBands(g, centers[i].node, thresholds, contexts[worker], found[worker]);
+        int reached = 0;
+        long long reachedBeds = 0;
+        for (size_t b = 0; b < bands; ++b) {
+            for (const auto& entry : found[worker][b].reached) {
+                ++reached;
+                reachedBeds += beds[entry.first];
+            }
+            centerCounts[i * bands + b] = reached;
+            bedCounts[i * bands + b] = reachedBeds;
+        }
+    });
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    ofstream out(filename);
+    out << "CenterID";
+    for (int minutes : thresholds) out << ",Centers" << minutes << "Min,Beds" << minutes << "Min";
+    out << "\n";
+    for (size_t i = 0; i < centers.size(); ++i) {
+        out << centers[i].id;
+        for (size_t b = 0; b < bands; ++b) out << "," << centerCounts[i * bands + b] << "," << bedCounts[i * bands + b];
+        out << "\n";
+    }
+    cout << "Coverage table for " << centers.size() << " centers saved to '" << filename << "' (" << fixed
+         << setprecision(1) << ms << " ms on " << pool.size() << " threads).\n";
+}
+
+// Betweenness centrality
+// Brandes: a Dijkstra from each source counts the shortest paths to every
+// node, then a pass in reverse settling order hands each node's dependency
+// back to its predecessors and to the arcs they arrive by. Lengths are whole
+// metres so ties between equal routes are exact. Sources are spread over the
+// worker pool and each worker adds into its own node and arc totals, which
+// are merged at the end. Both directions of a route are counted, so totals
+// are halved. With sampling, k random sources stand in for all n and the
+// totals are scaled by n / k. What one source adds to a normalised score is
+// at most 1 for a connection and n / (n - 1) for a center, so by Hoeffding's
+// inequality and a union bound every normalised score is within that range
+// times sqrt(ln(2N / alpha) / 2k) of the exact one with probability
+// 1 - alpha, N being the number of scores bounded at once.
+const double BETWEENNESS_ALPHA = 0.05;
+
+struct BrandesScratch {
+    vector<long long> dist;
+    vector<double> sigma, delta;
+    vector<int> order, position;
+    vector<double> nodeScore, arcScore;
+};
+
+struct Betweenness {
+    vector<double> node; // Per node
+    vector<double> arc;  // Per CSR arc; a connection's score is its two arcs together
+    int sources = 0;
+    bool sampled = false;
+    double nodeError = 0, arcError = 0; // Hoeffding bounds on normalised scores when sampled
+};
+
+// Adds the dependencies of every node and arc on shortest paths from s to
+// the nodes marked in isCenter. Connection endpoints without a center record
+// are passed through but never counted as a destination, so pairs stay
+// symmetric and the halving in computeBetweenness holds.
+void brandesFromSource(const CSRGraph& g, const vector<long long>& metres, const vector<char>& isCenter, int s,
+                       BrandesScratch& ws) {
+    int n = g.numNodes();
+    const long long unreached = numeric_limits<long long>::max();
+    for (int v : ws.order) {
+        ws.dist[v] = unreached;
+        ws.sigma[v] = ws.delta[v] = 0;
+        ws.position[v] = -1;
+    }
+    if ((int)ws.dist.size() != n) {
+        ws.dist.assign(n, unreached);
+        ws.sigma.assign(n, 0);
+        ws.delta.assign(n, 0);
+        ws.position.assign(n, -1);
+    }
+    ws.order.clear();
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> pq;
+    ws.dist[s] = 0;
+    ws.sigma[s] = 1;
+    pq.push({0, s});
+    while (!pq.empty()) {
+        auto [d, u] = pq.top();
+        pq.pop();
+        if (d > ws.dist[u] || ws.position[u] >= 0) continue;
+        ws.position[u] = ws.order.size();
+        ws.order.push_back(u);
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int v = g.targets[e];
+            if (ws.position[v] >= 0) continue;
+            long long via = d + metres[e];
+            if (via < ws.dist[v]) {
+                ws.dist[v] = via;
+                ws.sigma[v] = ws.sigma[u];
+                pq.push({via, v});
+            } else if (via == ws.dist[v]) {
+                ws.sigma[v] += ws.sigma[u];
+            }
+        }
+    }
+    for (int i = (int)ws.order.size() - 1; i > 0; --i) {
+        int w = ws.order[i];
+        double share = ((isCenter[w] ? 1 : 0) + ws.delta[w]) / ws.sigma[w];
+        for (int e = g.offsets[w]; e < g.offsets[w + 1]; ++e) {
+            int v = g.targets[e];
+            if (ws.position[v] < 0 || ws.position[v] >= i || ws.dist[v] + metres[e] != ws.dist[w]) continue;
+            double credit = ws.sigma[v] * share;
+            ws.delta[v] += credit;
+            ws.arcScore[e] += credit;
+        }
+        ws.nodeScore[w] += ws.delta[w];
+    }
+}
+
+// Exact scores when samples is 0 or covers every center, otherwise an
+// estimate from that many random source centers.
+void computeBetweenness(const CSRGraph& g, int samples, unsigned seed, Betweenness& result) {
+    int n = g.numNodes(), m = g.numEdges();
+    vector<int> sources;
+    vector<char> isCenter(n, 0);
+    for (const auto& hc : centers) {
+        sources.push_back(hc.node);
+        isCenter[hc.node] = 1;
+    }
+    int total = sources.size();
+    result.sampled = samples > 0 && samples < total;
+    if (result.sampled) {
+        mt19937 rng(seed);
+        shuffle(sources.begin(), sources.end(), rng);
+        sources.resize(samples);
+    }
+    result.sources = sources.size();
+    vector<long long> metres(m);
+    for (int e = 0; e < m; ++e) metres[e] = llround((double)g.weights[e] * 1000);
+
+    ThreadPool& pool = workerPool();
+    vector<BrandesScratch> scratch(pool.size());
+    for (auto& ws : scratch) {
+        ws.nodeScore.assign(n, 0);
+        ws.arcScore.assign(m, 0);
+    }
+    pool.parallelFor(sources.size(), [&](size_t i, unsigned worker) {
+        brandesFromSource(g, metres, isCenter, sources[i], scratch[worker]);
+    });
+
+    double scale = (result.sampled ? (double)total / result.sources : 1.0) / 2;
+    result.node.assign(n, 0);
+    result.arc.assign(m, 0);
+    for (auto& ws : scratch) {
+        for (int v = 0; v < n; ++v) result.node[v] += ws.nodeScore[v] * scale;
+        for (int e = 0; e < m; ++e) result.arc[e] += ws.arcScore[e] * scale;
+    }
+    result.nodeError = result.arcError = 0;
+    if (result.sampled) {
+        double k = result.sources;
+        result.nodeError = total / (total - 1.0) * sqrt(log(2.0 * total / BETWEENNESS_ALPHA) / (2 * k));
+        result.arcError = sqrt(log(2.0 * max(1, m / 2) / BETWEENNESS_ALPHA) / (2 * k));
+    }
+}
+
+// Normalisers: the most a node (pairs not involving it) or a connection
+// (every pair) can score.
+double nodeBetweennessScale(int centerCount) {
+    return max(1.0, (centerCount - 1.0) * (centerCount - 2.0) / 2);
+}
+
+double arcBetweennessScale(int centerCount) {
+    return max(1.0, centerCount * (centerCount - 1.0) / 2);
+}
+
+// Computes betweenness, prints the ten highest centers and connections and
+// writes every score to the two CSV files.
+void betweennessCentrality(int samples) {
+    ensureAdjacency();
+    const CSRGraph& g = graph();
+    if (centers.size() < 3) {
+        cout << "Need at least 3 health centers.\n";
+        return;
+    }
+    Betweenness result;
+    auto t0 = chrono::steady_clock::now();
+    computeBetweenness(g, samples, random_device{}(), result);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    double nodeScale = nodeBetweennessScale(centers.size()), arcScale = arcBetweennessScale(centers.size());
+
+    struct Row {
+        double score;
+        int u, slot;
+    };
+    vector<Row> nodes, links;
+    for (const auto& hc : centers) nodes.push_back({result.node[hc.node], hc.node, -1});
+    for (int u = 0; u < g.numNodes(); ++u) {
+        for (int slot = 0; slot < (int)adjList[u].size(); ++slot) {
+            const Connection& c = adjList[u][slot];
+            if (u > c.to || (c.to == u && c.twin < slot)) continue;
+            double score = result.arc[g.offsets[u] + slot] + result.arc[g.offsets[c.to] + c.twin];
+            links.push_back({score, u, slot});
+        }
+    }
+    auto byScore = [](const Row& a, const Row& b) { return a.score > b.score; };
+    stable_sort(nodes.begin(), nodes.end(), byScore);
+    stable_sort(links.begin(), links.end(), byScore);
+
+    ofstream nodeFile("betweenness_centers.csv");
+    nodeFile << "CenterID,Name,Betweenness,Normalized\n";
+    for (const Row& r : nodes) {
+        const HealthCenter& hc = *findCenter(idOf(r.u));
+        nodeFile << hc.id << "," << hc.name << "," << r.score << "," << r.score / nodeScale << "\n";
+    }
+    ofstream linkFile("betweenness_connections.csv");
+    linkFile << "FromID,ToID,DistanceKM,Description,Betweenness,Normalized\n";
+    for (const Row& r : links) {
+        const Connection& c = adjList[r.u][r.slot];
+        linkFile << idOf(r.u) << "," << idOf(c.to) << "," << c.distance << "," << connectionDescriptions[c.descId] << ","
+                 << r.score << "," << r.score / arcScale << "\n";
+    }
+
+    cout << fixed << setprecision(1) << (result.sampled ? "Estimated" : "Exact") << " betweenness from "
+         << result.sources << " source(s) in " << ms << " ms on " << workerPool().size() << " threads.\n";
+    if (result.sampled) {
+        cout << setprecision(4) << "With " << (int)((1 - BETWEENNESS_ALPHA) * 100)
+             << "% confidence normalized scores are within " << result.nodeError << " (centers) and "
+             << result.arcError << " (connections).\n";
+    }
+    cout << setprecision(4) << "Top centers:\n";
+    for (size_t i = 0; i < min<size_t>(10, nodes.size()); ++i) {
+        cout << "  " << idOf(nodes[i].u) << ": " << nodes[i].score / nodeScale << "\n";
+    }
+    cout << "Top connections:\n";
+    for (size_t i = 0; i < min<size_t>(10, links.size()); ++i) {
+        const Connection& c = adjList[links[i].u][links[i].slot];
+        cout << "  " << idOf(links[i].u) << " - " << idOf(c.to) << ": " << links[i].score / arcScale << "\n";
+    }
+    cout << "Scores saved to 'betweenness_centers.csv' and 'betweenness_connections.csv'.\n";
+}
+
+// Batch queries
+// A batch file holds one query per line, fields separated by spaces or commas:
+//   shortest <FromID> <ToID>
+//   distance <FromID> <ToID>       road distance only, from the hub labels
+//   bfs <StartID>
+//   within <StartID> <MaxHops>
+//   emergency <StartID> <MinCapacity>
+// Blank lines and lines starting with '#' are ignored. Queries are answered on
+// the worker pool, each worker reusing its own SearchWorkspace, and results
+// are written in input order as CSV or JSON lines.
+struct BatchQuery {
+    int line;
+    string type;
+    CenterId a = -1, b = -1; // Center ids, or a capacity or hop limit for b
+};
+
+struct BatchResult {
+    string status;
+    float distance = 0;
+    vector<int> nodes; // Path for shortest/emergency, visit order for bfs/within
+};
+
+struct SearchWorkspace {
+    QueryContext query;
+    HopSearch hops;
+    vector<int> landmarks; // Active ALT landmarks of the current query
+};
+
+const size_t BATCH_CHUNK = 1 << 16;
+
+bool parseBatchQuery(string text, int line, BatchQuery& q) {
+    replace(text.begin(), text.end(), ',', ' ');
+    stringstream ss(text);
+    q = BatchQuery();
+    q.line = line;
+    if (!(ss >> q.type)) return false;
+    transform(q.type.begin(), q.type.end(), q.type.begin(), ::tolower);
+    if (q.type == "bfs") return (bool)(ss >> q.a);
+    if (q.type == "shortest" || q.type == "distance" || q.type == "emergency") return (bool)(ss >> q.a >> q.b);
+    if (q.type == "within") return (bool)(ss >> q.a >> q.b) && q.b >= 0;
+    return false;
+}
+
+BatchResult batchFailure(const string& status) {
+    BatchResult r;
+    r.status = status;
+    return r;
+}
+
+// landmarks, when not null, is a table for the current network that shortest
+// queries search with instead of the great-circle A* bound. labels answers
+// distance queries and is loaded or built before the batch starts.
+BatchResult runBatchQuery(const BatchQuery& q, SearchWorkspace& ws, const LandmarkTable* landmarks,
+                          const HubLabels* labels) {
+    BatchResult r;
+    const CSRGraph& g = network;
+    int a = nodeOf(q.a);
+    if (a < 0 || a >= g.numNodes()) return batchFailure("invalid_id");
+    if (q.type == "shortest") {
+        int b = nodeOf(q.b);
+        if (b < 0 || b >= g.numNodes()) return batchFailure("invalid_id");
+        if (connectivity.sets.root(a) != connectivity.sets.root(b)) return batchFailure("no_path");
+        if (landmarks) altSearch(g, *landmarks, a, b, ws.query, ws.landmarks);
+        else aStarSearch(g, a, b, ws.query);
+        if (ws.query.distance(b) == INF) return batchFailure("no_path");
+        r.distance = ws.query.dist[b];
+        for (int at = b; at != -1; at = ws.query.prev[at]) r.nodes.push_back(at);
+        reverse(r.nodes.begin(), r.nodes.end());
+    } else if (q.type == "distance") {
+        int b = nodeOf(q.b);
+        if (b < 0 || b >= g.numNodes()) return batchFailure("invalid_id");
+        r.distance = hubDistance(*labels, a, b);
+        if (r.distance == INF) return batchFailure("no_path");
+    } else if (q.type == "bfs") {
+        bfsOrder(g, a, ws.query, r.nodes);
+    } else if (q.type == "within") {
+        // Workers already run queries in parallel, so each search stays serial.
+        hopDistances(g, {a}, (int)min<CenterId>(q.b, INT32_MAX), ws.hops, false);
+        for (int v = 0; v < g.numNodes(); ++v) {
+            if (ws.hops.hops[v] >= 0) r.nodes.push_back(v);
+        }
+        stable_sort(r.nodes.begin(), r.nodes.end(), [&](int x, int y) { return ws.hops.hops[x] < ws.hops.hops[y]; });
+    } else {
+        const CapacityLayer& layer = capacityLayers.at((int)q.b);
+        if (layer.owner[a] < 0) return batchFailure("no_center");
+        r.distance = layer.dist[a];
+        for (int at = a; at != -1; at = layer.nextHop[at]) r.nodes.push_back(at);
+    }
+    r.status = "ok";
+    return r;
+}
+
+string formatBatchResult(const BatchQuery& q, const BatchResult& r, bool json) {
+    ostringstream out;
+    out << fixed << setprecision(3);
+    bool visitList = q.type == "bfs" || q.type == "within";
+    if (json) {
+        out << "{\"line\":" << q.line << ",\"type\":\"" << q.type << "\",\"from\":" << q.a;
+        if (q.type == "shortest" || q.type == "distance") out << ",\"to\":" << q.b;
+        if (q.type == "emergency") out << ",\"minCapacity\":" << q.b;
+        if (q.type == "within") out << ",\"maxHops\":" << q.b;
+        out << ",\"status\":\"" << r.status << "\"";
+        if (r.status == "ok") {
+            if (!visitList) out << ",\"distance\":" << r.distance;
+            if (q.type != "distance") {
+                out << (visitList ? ",\"visited\":[" : ",\"path\":[");
+                for (size_t i = 0; i < r.nodes.size(); ++i) out << (i ? "," : "") << idOf(r.nodes[i]);
+                out << "]";
+            }
+        }
+        out << "}\n";
+    } else {
+        out << q.line << "," << q.type << "," << q.a << ",";
+        if (q.type != "bfs") out << q.b;
+        out << "," << r.status << ",";
+        if (r.status == "ok" && !visitList) out << r.distance;
+        out << ",";
+        for (size_t i = 0; i < r.nodes.size(); ++i) out << (i ? " " : "") << idOf(r.nodes[i]);
+        out << "\n";
+    }
+    return out.str();
+}
+
+// Usage: --batch <queries> [--out <file>] [--format csv|jsonl] [--threads <n>]
+int runBatch(int argc, char* argv[]) {
+    string inputName = argc > 2 ? argv[2] : "", outputName, format = "csv";
+    unsigned threads = 0;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        string flag = argv[i];
+        if (flag == "--out") outputName = argv[i + 1];
+        else if (flag == "--format") format = argv[i + 1];
+        else if (flag == "--threads") threads = (unsigned)max(1, atoi(argv[i + 1]));
+        else {
+            cout << "Unknown batch option: " << flag << "\n";
+            return 1;
+        }
+    }
+    if (format != "csv" && format != "jsonl") {
+        cout << "Format must be csv or jsonl.\n";
+        return 1;
+    }
+    bool json = format == "jsonl";
+    if (outputName.empty()) outputName = json ? "batch_results.jsonl" : "batch_results.csv";
+    ifstream in(inputName);
+    if (!in.is_open()) {
+        cout << "Error opening " << inputName << endl;
+        return 1;
+    }
+
+    vector<BatchQuery> queries;
+    string line;
+    for (int lineNo = 1; getline(in, line); ++lineNo) {
+        if (line.empty() || line[0] == '#') continue;
+        BatchQuery q;
+        if (!parseBatchQuery(line, lineNo, q)) {
+            cout << "Skipping invalid query on line " << lineNo << ": " << line << endl;
+            continue;
+        }
+        queries.push_back(q);
+    }
+
+    // Everything the workers read is prepared up front so they share it read-only.
+    graph();
+    connectivityIndex();
+    const LandmarkTable* landmarks = freshLandmarks("connections.alt");
+    const HubLabels* labels = nullptr;
+    for (const auto& q : queries) {
+        if (q.type == "emergency") capacityLayer((int)q.b);
+        if (q.type == "distance" && !labels) labels = &currentHubLabels("connections.hl");
+    }
+
+    unique_ptr<ThreadPool> ownPool;
+    if (threads) ownPool.reset(new ThreadPool(threads));
+    ThreadPool& pool = ownPool ? *ownPool : workerPool();
+    vector<SearchWorkspace> workspaces(pool.size());
+
+    ofstream out(outputName);
+    if (!json) out << "Line,Type,From,To,Status,DistanceKM,Nodes\n";
+    auto t0 = chrono::steady_clock::now();
+    vector<string> formatted;
+    for (size_t first = 0; first < queries.size(); first += BATCH_CHUNK) {
+        size_t count = min(BATCH_CHUNK, queries.size() - first);
+        formatted.assign(count, "");
+        pool.parallelFor(count, [&](size_t i, unsigned worker) {
+            const BatchQuery& q = queries[first + i];
+            formatted[i] = formatBatchResult(q, runBatchQuery(q, workspaces[worker], landmarks, labels), json);
+        });
+        for (const auto& text : formatted) out << text;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << "Answered " << queries.size() << " queries on " << pool.size() << " threads in "
+         << fixed << setprecision(3) << seconds << " s. Results written to " << outputName << ".\n";
+    return 0;
+}
+
+// Binary network snapshot
+// A snapshot stores the centers, the CSR arrays and a string table in one
+// file that is memory-mapped at startup. The CSR arrays are used in place;
+// only the center records are copied out, and adjList is rebuilt from the
+// mapping the first time something edits or lists the connections.
+//
+// Layout: SnapshotHeader, then 8-byte aligned sections at the offsets it
+// records: SnapshotCenter[numCenters], offsets[numNodes + 1], targets,
+// weights, times, descIds (numEdges each), lat and lon[numNodes],
+// SnapshotString[numDescriptions], the character data and the center id of
+// every node (nodeIds[numNodes], -1 for a free node).
+const char SNAPSHOT_MAGIC[4] = {'H', 'C', 'N', 'S'};
+const uint32_t SNAPSHOT_VERSION = 2;
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t sourceStamp; // Identifies the CSV files the snapshot was built from
+    uint64_t numCenters;
+    uint64_t numNodes;
+    uint64_t numEdges;
+    uint64_t numDescriptions;
+    float heuristicScale;
+    uint32_t reserved;
+    uint64_t centersOffset, offsetsOffset, targetsOffset, weightsOffset, timesOffset, descIdsOffset;
+    uint64_t latOffset, lonOffset, descriptionsOffset, charsOffset, nodeIdsOffset, fileSize;
+};
+
+struct SnapshotString {
+    uint64_t offset;
+    uint64_t length;
+};
+
+struct SnapshotCenter {
+    int64_t id;
+    float lat, lon;
+    int32_t capacity;
+    int32_t node;
+    SnapshotString name, district;
+};
+
+MappedFile snapshotFile;
+
+// Changes whenever either CSV file is rewritten.
+uint64_t csvStamp(const string& centersFile, const string& connectionsFile) {
+    uint64_t h = 1469598103934665603ULL;
+    for (const string& name : {centersFile, connectionsFile}) {
+        error_code ec;
+        uint64_t size = filesystem::file_size(name, ec);
+        if (ec) return 0;
+        uint64_t mtime = (uint64_t)filesystem::last_write_time(name, ec).time_since_epoch().count();
+        for (uint64_t v : {size, mtime}) h = (h ^ v) * 1099511628211ULL;
+    }
+    return h;
+}
+
+void writeSnapshot(const string& filename, uint64_t sourceStamp) {
+    const CSRGraph& g = graph();
+    ostringstream body;
+    SnapshotHeader header = {};
+    copy(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC + 4, header.magic);
+    header.version = SNAPSHOT_VERSION;
+    header.sourceStamp = sourceStamp;
+    header.numCenters = centers.size();
+    header.numNodes = g.numNodes();
+    header.numEdges = g.numEdges();
+    header.numDescriptions = connectionDescriptions.size();
+    header.heuristicScale = g.heuristicScale;
+
+    string chars;
+    auto intern = [&chars](const string& text) {
+        SnapshotString ref = {chars.size(), text.size()};
+        chars += text;
+        return ref;
+    };
+    auto section = [&body](uint64_t& offset, const void* data, size_t bytes) {
+        while ((sizeof(SnapshotHeader) + (size_t)body.tellp()) % 8) body.put(0);
+        offset = sizeof(SnapshotHeader) + (uint64_t)body.tellp();
+        body.write(static_cast<const char*>(data), bytes);
+    };
+
+    vector<SnapshotCenter> records;
+    for (const auto& hc : centers) records.push_back({hc.id, hc.lat, hc.lon, hc.capacity, hc.node, intern(hc.name), intern(hc.district)});
+    vector<SnapshotString> descriptions;
+    for (const auto& desc : connectionDescriptions) descriptions.push_back(intern(desc));
+
+    section(header.centersOffset, records.data(), records.size() * sizeof(SnapshotCenter));
+    section(header.offsetsOffset, g.offsets.data(), g.offsets.size() * sizeof(int));
+    section(header.targetsOffset, g.targets.data(), g.targets.size() * sizeof(int));
+    section(header.weightsOffset, g.weights.data(), g.weights.size() * sizeof(float));
+    section(header.timesOffset, g.times.data(), g.times.size() * sizeof(int));
+    section(header.descIdsOffset, g.descIds.data(), g.descIds.size() * sizeof(int));
+    section(header.latOffset, g.lat.data(), g.lat.size() * sizeof(float));
+    section(header.lonOffset, g.lon.data(), g.lon.size() * sizeof(float));
+    section(header.descriptionsOffset, descriptions.data(), descriptions.size() * sizeof(SnapshotString));
+    section(header.charsOffset, chars.data(), chars.size());
+    section(header.nodeIdsOffset, nodeIds.data(), nodeIds.size() * sizeof(CenterId));
+    header.fileSize = sizeof(SnapshotHeader) + (uint64_t)body.tellp();
+
+    string tmp = filename + ".tmp";
+    {
+        ofstream out(tmp, ios::binary);
+        writePod(out, header);
+        out << body.str();
+    }
+    filesystem::rename(tmp, filename);
+}
+
+const SnapshotHeader* snapshotHeader() {
+    return reinterpret_cast<const SnapshotHeader*>(snapshotFile.data());
+}
+
+string snapshotString(const SnapshotString& ref) {
+    return string(snapshotFile.data() + snapshotHeader()->charsOffset + ref.offset, ref.length);
+}
+
+// Checks that every section of a mapped snapshot lies inside the file and
+// that every stored index is in range, so a truncated or corrupted file that
+// still carries the right CSV stamp is rejected instead of read out of bounds.
+bool validSnapshot(const MappedFile& file, const SnapshotHeader& h) {
+    const uint64_t size = file.size();
+    if (h.numNodes >= (uint64_t)numeric_limits<int>::max() || h.numEdges > (uint64_t)numeric_limits<int>::max() ||
+        h.numDescriptions > (uint64_t)numeric_limits<int>::max()) {
+        return false;
+    }
+    auto fits = [size](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset >= sizeof(SnapshotHeader) && offset % 8 == 0 && offset <= size &&
+               count <= (size - offset) / elementSize;
+    };
+    if (!fits(h.centersOffset, h.numCenters, sizeof(SnapshotCenter)) ||
+        !fits(h.offsetsOffset, h.numNodes + 1, sizeof(int)) ||
+        !fits(h.targetsOffset, h.numEdges, sizeof(int)) || !fits(h.weightsOffset, h.numEdges, sizeof(float)) ||
+        !fits(h.timesOffset, h.numEdges, sizeof(int)) || !fits(h.descIdsOffset, h.numEdges, sizeof(int)) ||
+        !fits(h.latOffset, h.numNodes, sizeof(float)) || !fits(h.lonOffset, h.numNodes, sizeof(float)) ||
+        !fits(h.descriptionsOffset, h.numDescriptions, sizeof(SnapshotString)) ||
+        !fits(h.nodeIdsOffset, h.numNodes, sizeof(CenterId)) ||
+        h.charsOffset < sizeof(SnapshotHeader) || h.charsOffset > h.nodeIdsOffset) {
+        return false;
+    }
+
+    // The character data runs up to the node id section that follows it.
+    const char* base = file.data();
+    const uint64_t charsSize = h.nodeIdsOffset - h.charsOffset;
+    auto validString = [charsSize](const SnapshotString& ref) {
+        return ref.offset <= charsSize && ref.length <= charsSize - ref.offset;
+    };
+    const int numNodes = (int)h.numNodes, numEdges = (int)h.numEdges;
+    const int* offsets = reinterpret_cast<const int*>(base + h.offsetsOffset);
+    if (offsets[0] != 0 || offsets[numNodes] != numEdges) return false;
+    for (int u = 0; u < numNodes; ++u) {
+        if (offsets[u] > offsets[u + 1]) return false;
+    }
+    const int* targets = reinterpret_cast<const int*>(base + h.targetsOffset);
+    const int* descIds = reinterpret_cast<const int*>(base + h.descIdsOffset);
+    for (int e = 0; e < numEdges; ++e) {
+        if (targets[e] < 0 || targets[e] >= numNodes || descIds[e] < 0 || descIds[e] >= (int)h.numDescriptions) return false;
+    }
+    const SnapshotCenter* records = reinterpret_cast<const SnapshotCenter*>(base + h.centersOffset);
+    for (uint64_t i = 0; i < h.numCenters; ++i) {
+        const SnapshotCenter& r = records[i];
+        if (r.node < 0 || r.node >= numNodes || !validString(r.name) || !validString(r.district)) return false;
+    }
+    const SnapshotString* descriptions = reinterpret_cast<const SnapshotString*>(base + h.descriptionsOffset);
+    for (uint64_t i = 0; i < h.numDescriptions; ++i) {
+        if (!validString(descriptions[i])) return false;
+    }
+    return true;
+}
+
+// Maps filename and points the network at it. Fails, leaving the network
+// untouched, when the file is missing, malformed or built from other CSVs.
+bool loadSnapshot(const string& filename, uint64_t sourceStamp) {
+    MappedFile file;
+    if (!file.open(filename) || file.size() < sizeof(SnapshotHeader)) return false;
+    const SnapshotHeader& h = *reinterpret_cast<const SnapshotHeader*>(file.data());
+    if (!equal(h.magic, h.magic + 4, SNAPSHOT_MAGIC) || h.version != SNAPSHOT_VERSION ||
+        h.sourceStamp != sourceStamp || h.fileSize != file.size() || !validSnapshot(file, h)) {
+        return false;
+    }
+    snapshotFile.swap(file);
+    const char* base = snapshotFile.data();
+    auto at = [base](uint64_t offset) { return base + offset; };
+
+    const SnapshotCenter* records = reinterpret_cast<const SnapshotCenter*>(at(h.centersOffset));
+    centers.clear();
+    centerGrid.stale = true;
+    centerSlotsStale = true;
+    centers.reserve(h.numCenters);
+    for (uint64_t i = 0; i < h.numCenters; ++i) {
+        const SnapshotCenter& r = records[i];
+        centers.push_back({r.id, snapshotString(r.name), snapshotString(r.district), r.lat, r.lon, r.capacity, r.node});
+    }
+    const CenterId* ids = reinterpret_cast<const CenterId*>(at(h.nodeIdsOffset));
+    clearNodes();
+    nodeIds.assign(ids, ids + h.numNodes);
+    nodeIndex.reserve(h.numNodes);
+    for (int node = 0; node < (int)h.numNodes; ++node) {
+        if (ids[node] >= 0) nodeIndex[ids[node]] = node;
+        else freeNodes.push_back(node);
+    }
+
+    network.offsets.view(reinterpret_cast<const int*>(at(h.offsetsOffset)), h.numNodes + 1);
+    network.targets.view(reinterpret_cast<const int*>(at(h.targetsOffset)), h.numEdges);
+    network.weights.view(reinterpret_cast<const float*>(at(h.weightsOffset)), h.numEdges);
+    network.times.view(reinterpret_cast<const int*>(at(h.timesOffset)), h.numEdges);
+    network.descIds.view(reinterpret_cast<const int*>(at(h.descIdsOffset)), h.numEdges);
+    network.lat.view(reinterpret_cast<const float*>(at(h.latOffset)), h.numNodes);
+    network.lon.view(reinterpret_cast<const float*>(at(h.lonOffset)), h.numNodes);
+    network.heuristicScale = h.heuristicScale;
+
+    adjList.clear();
+    clearDescriptions();
+    capacityLayers.clear();
+    connectivity.stale = true;
+    adjacencyPending = true;
+    networkDirty = false;
+    ++networkVersion;
+    return true;
+}
+
+void materializeAdjacency() {
+    adjacencyPending = false;
+    const SnapshotHeader& h = *snapshotHeader();
+    const SnapshotString* descriptions = reinterpret_cast<const SnapshotString*>(snapshotFile.data() + h.descriptionsOffset);
+    clearDescriptions();
+    connectionDescriptions.reserve(h.numDescriptions);
+    for (uint64_t i = 0; i < h.numDescriptions; ++i) connectionDescriptions.push_back(snapshotString(descriptions[i]));
+    descriptionRefs.assign(h.numDescriptions, 0);
+
+    // The CSR arrays hold no twin positions, so each half-edge is paired with
+    // an unpaired half of the same connection seen earlier: same endpoints,
+    // description, distance and time. unpaired[v] lists (node, slot) of the
+    // halves still waiting for their twin in v's list.
+    const CSRGraph& g = network;
+    adjList.assign(g.numNodes(), {});
+    vector<vector<pair<int, int>>> unpaired(g.numNodes());
+    for (int u = 0; u < g.numNodes(); ++u) {
+        adjList[u].reserve(g.degree(u));
+        for (int e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+            int slot = e - g.offsets[u], v = g.targets[e];
+            adjList[u].push_back({v, g.weights[e], g.times[e], g.descIds[e], -1});
+            vector<pair<int, int>>& waiting = unpaired[u];
+            auto match = find_if(waiting.begin(), waiting.end(), [&](const pair<int, int>& half) {
+                const Connection& c = adjList[half.first][half.second];
+                return half.first == v && c.descId == g.descIds[e] && c.distance == g.weights[e] && c.time == g.times[e];
+            });
+            if (match != waiting.end()) {
+                adjList[u][slot].twin = match->second;
+                adjList[v][match->second].twin = slot;
+                ++descriptionRefs[g.descIds[e]];
+                *match = waiting.back();
+                waiting.pop_back();
+            } else {
+                unpaired[v].push_back({u, slot});
+            }
+        }
+        vector<pair<int, int>>().swap(unpaired[u]);
+    }
+    for (int descId = 0; descId < (int)descriptionRefs.size(); ++descId) {
+        if (descriptionRefs[descId] == 0) freeDescriptions.push_back(descId);
+    }
+}
+
+// Loads the network from the snapshot when it matches the CSV files, and
+// from the CSV files otherwise. A stale snapshot is regenerated afterwards.
+void loadNetwork(const string& centersFile, const string& connectionsFile, const string& snapshotName) {
+    uint64_t stamp = csvStamp(centersFile, connectionsFile);
+    if (stamp && loadSnapshot(snapshotName, stamp)) return;
+    readHealthCenters(centersFile);
+    readConnections(connectionsFile);
+    if (stamp && fileExists(snapshotName)) writeSnapshot(snapshotName, stamp);
+}
+
+// Synthetic networks and benchmarks
+using BenchClock = chrono::steady_clock;
+
+double elapsedMs(BenchClock::time_point since) {
+    return chrono::duration<double, milli>(BenchClock::now() - since).count();
+}
+
+// Layouts for generated networks: uniform random points, a jittered street
+// grid with a few missing blocks, or towns clustered around district hubs.
+enum class NetworkShape { Geometric, Grid, Clustered };
+const char* const NETWORK_SHAPE_NAMES[] = {"geometric", "grid", "clustered"};
+const float SYNTHETIC_LAT_MIN = -2.8f, SYNTHETIC_LON_MIN = 28.9f, SYNTHETIC_SPAN = 2.0f;
+const int SYNTHETIC_DISTRICTS = 30;
+
+bool parseNetworkShape(const string& name, NetworkShape& shape) {
+    for (int i = 0; i < 3; ++i) {
+        if (name == NETWORK_SHAPE_NAMES[i]) {
+            shape = (NetworkShape)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Road speeds in km/h; each generated road gets one at random.
+const float SYNTHETIC_SPEEDS_KMH[] = {30, 50, 80};
+
+// Adds a road between i and j (unless one exists) whose length is the
+// straight line stretched by the given detour factor.
+void addSyntheticRoad(int i, int j, float detourFactor, float speedKmh, int descId) {
+    if (i == j || findHalfEdge(i, j) >= 0) return;
+    float distance = haversineKm(centers[i].lat, centers[i].lon, centers[j].lat, centers[j].lon) * detourFactor;
+    int minutes = max(1, (int)lround(distance / speedKmh * 60));
+    linkHalfEdges(i, j, distance, minutes, descId);
+}
+
+// Links every center to its k nearest neighbours, bucketing centers into a
+// grid with about two centers per cell to find the candidates.
+void linkNearestNeighbours(int k, mt19937& rng, int descId) {
+    int n = centers.size();
+    uniform_real_distribution<float> detour(1.0f, 1.3f);
+    int side = max(1, (int)sqrt(n / 2.0));
+    auto cellOf = [&](float v, float lo) { return min(side - 1, max(0, (int)((v - lo) / SYNTHETIC_SPAN * side))); };
+    vector<vector<int>> cells(side * side);
+    for (int i = 0; i < n; ++i) {
+        cells[cellOf(centers[i].lat, SYNTHETIC_LAT_MIN) * side + cellOf(centers[i].lon, SYNTHETIC_LON_MIN)].push_back(i);
+    }
+
+    vector<pair<float, int>> candidates;
+    for (int i = 0; i < n; ++i) {
+        int cr = cellOf(centers[i].lat, SYNTHETIC_LAT_MIN), cc = cellOf(centers[i].lon, SYNTHETIC_LON_MIN);
+        candidates.clear();
+        for (int ring = 1; (int)candidates.size() < k && ring <= side; ++ring) {
+            candidates.clear();
+            for (int r = max(0, cr - ring); r <= min(side - 1, cr + ring); ++r) {
+                for (int c = max(0, cc - ring); c <= min(side - 1, cc + ring); ++c) {
+                    for (int j : cells[r * side + c]) {
+                        if (j != i) candidates.push_back({haversineKm(centers[i].lat, centers[i].lon, centers[j].lat, centers[j].lon), j});
+                    }
+                }
+            }
+        }
+        int take = min(k, (int)candidates.size());
+        partial_sort(candidates.begin(), candidates.begin() + take, candidates.end());
+        for (int t = 0; t < take; ++t) {
+            addSyntheticRoad(i, candidates[t].second, detour(rng), SYNTHETIC_SPEEDS_KMH[rng() % 3], descId);
+        }
+    }
+}
+
+// Replaces the loaded network with n generated centers spread over a 2 x 2
+// degree box in the given layout. Road distances run 0-30% longer than the
+// straight line and each road is driven at 30, 50 or 80 km/h. Geometric and clustered
+// centers link to their nearest neighbours.
+void generateSyntheticNetwork(int n, NetworkShape shape, unsigned seed, int neighbours = 4) {
+    mt19937 rng(seed);
+    uniform_real_distribution<float> latDist(SYNTHETIC_LAT_MIN, SYNTHETIC_LAT_MIN + SYNTHETIC_SPAN);
+    uniform_real_distribution<float> lonDist(SYNTHETIC_LON_MIN, SYNTHETIC_LON_MIN + SYNTHETIC_SPAN);
+    uniform_real_distribution<float> detour(1.0f, 1.3f), unit(0.0f, 1.0f);
+    centers.clear();
+    centers.reserve(n);
+    capacityLayers.clear();
+    connectivity.stale = true;
+    centerGrid.stale = true;
+    centerSlotsStale = true;
+    adjacencyPending = false;
+    adjList.assign(n, {});
+    clearDescriptions();
+    clearNodes();
+    nodeIndex.reserve(n);
+    int descId = addDescription("Synthetic road");
+    auto addCenter = [&](int district, float lat, float lon) {
+        int i = centers.size();
+        centers.push_back({i, "Center " + to_string(i), "District " + to_string(district), lat, lon, 10 + (int)(rng() % 491), i});
+        nodeIds.push_back(i);
+        nodeIndex.emplace(i, i);
+    };
+
+    if (shape == NetworkShape::Geometric) {
+        for (int i = 0; i < n; ++i) {
+            float lat = latDist(rng), lon = lonDist(rng);
+            addCenter(i % SYNTHETIC_DISTRICTS, lat, lon);
+        }
+        linkNearestNeighbours(neighbours, rng, descId);
+    } else if (shape == NetworkShape::Grid) {
+        // Street grid: each intersection sits within 30% of a cell of its
+        // lattice point, 10% of blocks are missing a side and some have a
+        // diagonal shortcut. Districts are a 6 x 5 partition of the grid.
+        int side = max(1, (int)ceil(sqrt((double)n)));
+        float cell = SYNTHETIC_SPAN / side;
+        uniform_real_distribution<float> jitter(-0.3f, 0.3f);
+        for (int i = 0; i < n; ++i) {
+            int r = i / side, c = i % side;
+            float lat = SYNTHETIC_LAT_MIN + (r + 0.5f + jitter(rng)) * cell;
+            float lon = SYNTHETIC_LON_MIN + (c + 0.5f + jitter(rng)) * cell;
+            addCenter(r * 6 / side * 5 + c * 5 / side, lat, lon);
+        }
+        for (int i = 0; i < n; ++i) {
+            int c = i % side;
+            float speed = SYNTHETIC_SPEEDS_KMH[rng() % 3];
+            if (c + 1 < side && i + 1 < n && unit(rng) < 0.9f) addSyntheticRoad(i, i + 1, detour(rng), speed, descId);
+            if (i + side < n && unit(rng) < 0.9f) addSyntheticRoad(i, i + side, detour(rng), speed, descId);
+            if (c + 1 < side && i + side + 1 < n && unit(rng) < 0.15f) {
+                addSyntheticRoad(i, i + side + 1, detour(rng), speed, descId);
+            }
+        }
+    } else {
+        // Towns scattered around district hubs; the first center of each
+        // district is its hub and trunk roads join every hub to the three
+        // nearest other hubs.
+        int districts = min(n, SYNTHETIC_DISTRICTS);
+        uniform_real_distribution<float> hubLat(SYNTHETIC_LAT_MIN + 0.15f, SYNTHETIC_LAT_MIN + SYNTHETIC_SPAN - 0.15f);
+        uniform_real_distribution<float> hubLon(SYNTHETIC_LON_MIN + 0.15f, SYNTHETIC_LON_MIN + SYNTHETIC_SPAN - 0.15f);
+        vector<pair<float, float>> hubs(districts);
+        for (auto& hub : hubs) hub = {hubLat(rng), hubLon(rng)};
+        normal_distribution<float> scatter(0.0f, 0.08f);
+        auto clampTo = [](float v, float lo) { return min(lo + SYNTHETIC_SPAN, max(lo, v)); };
+        for (int i = 0; i < n; ++i) {
+            int d = i % districts;
+            float lat = i < districts ? hubs[d].first : clampTo(hubs[d].first + scatter(rng), SYNTHETIC_LAT_MIN);
+            float lon = i < districts ? hubs[d].second : clampTo(hubs[d].second + scatter(rng), SYNTHETIC_LON_MIN);
+            addCenter(d, lat, lon);
+        }
+        linkNearestNeighbours(neighbours, rng, descId);
+        for (int h = 0; h < districts; ++h) {
+            vector<pair<float, int>> nearest;
+            for (int o = 0; o < districts; ++o) {
+                if (o != h) nearest.push_back({haversineKm(hubs[h].first, hubs[h].second, hubs[o].first, hubs[o].second), o});
+            }
+            int take = min(3, (int)nearest.size());
+            partial_sort(nearest.begin(), nearest.begin() + take, nearest.end());
+            for (int t = 0; t < take; ++t) addSyntheticRoad(h, nearest[t].second, 1.1f, 80, descId);
+        }
+    }
+    networkDirty = true;
+    buildNetwork();
+}
+
+// Compares full Dijkstra with A* on random point-to-point queries.
+void benchAStar(int n, int queries, NetworkShape shape) {
+    auto genStart = BenchClock::now();
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    cout << "Synthetic network: " << g.numNodes() << " centers, " << g.numEdges() / 2
+         << " connections (generated in " << fixed << setprecision(1) << elapsedMs(genStart) << " ms)\n";
+
+    mt19937 rng(7);
+    vector<float> dist;
+    vector<int> prev;
+    QueryContext qc;
+    long long dijkstraSettled = 0, aStarSettled = 0;
+    double dijkstraMs = 0, aStarMs = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n, t = rng() % n;
+        auto t0 = BenchClock::now();
+        dijkstraSettled += dijkstraSearch(g, s, dist, prev);
+        dijkstraMs += elapsedMs(t0);
+        float expected = dist[t];
+
+        t0 = BenchClock::now();
+        aStarSettled += aStarSearch(g, s, t, qc);
+        aStarMs += elapsedMs(t0);
+        if (fabs(qc.distance(t) - expected) > 1e-3f * max(1.0f, expected)) ++mismatches;
+    }
+    cout << setprecision(3);
+    cout << "Dijkstra: " << (double)dijkstraSettled / queries << " settled/query, " << dijkstraMs / queries << " ms/query\n";
+    cout << "A*:       " << (double)aStarSettled / queries << " settled/query, " << aStarMs / queries << " ms/query\n";
+    cout << "Settled reduction: " << (double)dijkstraSettled / max(1LL, aStarSettled) << "x, distance mismatches: " << mismatches << "\n";
+}
+
+// Times the blocked all-pairs engine and spot-checks it against Dijkstra.
+void benchAllPairs(int n, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    auto t0 = BenchClock::now();
+    computeAllPairs();
+    double ms = elapsedMs(t0);
+
+    mt19937 rng(11);
+    vector<float> dist;
+    vector<int> prev;
+    int mismatches = 0;
+    for (int q = 0; q < 20; ++q) {
+        int s = rng() % n;
+        dijkstraSearch(graph(), s, dist, prev);
+        for (int t = 0; t < n; ++t) {
+            float d = fwDistances.at(s, t);
+            if (fabs(min(d, INF) - dist[t]) > 1e-3f * max(1.0f, dist[t])) ++mismatches;
+        }
+    }
+    cout << "Blocked Floyd-Warshall on " << n << " centers (" << workerPool().size() << " threads): "
+         << fixed << setprecision(1) << ms << " ms, mismatches vs Dijkstra: " << mismatches << "\n";
+}
+
+// Preprocessing cost, memory and query latency of the contraction hierarchy
+// against plain Dijkstra, checking that distances and paths agree.
+void benchContractionHierarchy(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    auto t0 = BenchClock::now();
+    ContractionHierarchy ch;
+    buildContractionHierarchy(g, ch);
+    double buildMs = elapsedMs(t0);
+    size_t graphBytes = (g.offsets.size() + g.targets.size()) * sizeof(int) + g.weights.size() * sizeof(float);
+    size_t chBytes = (ch.rank.size() + ch.upOffsets.size() + ch.upTargets.size() + ch.upMiddle.size()) * sizeof(int) +
+                     ch.upWeights.size() * sizeof(float);
+    cout << fixed << setprecision(3);
+    cout << "Network: " << n << " centers, " << g.numEdges() / 2 << " connections, " << graphBytes / 1024.0 << " KiB\n";
+    cout << "CH preprocessing: " << buildMs << " ms, " << ch.upTargets.size() << " upward arcs, " << chBytes / 1024.0 << " KiB\n";
+
+    mt19937 rng(7);
+    CHQuerySpace space;
+    vector<float> dist;
+    vector<int> prev, path, expected;
+    double dijkstraMs = 0, chMs = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n, t = rng() % n;
+        t0 = BenchClock::now();
+        dijkstraSearch(g, s, dist, prev);
+        dijkstraMs += elapsedMs(t0);
+        expected.clear();
+        if (dist[t] < INF) {
+            for (int at = t; at != -1; at = prev[at]) expected.push_back(at);
+            reverse(expected.begin(), expected.end());
+        }
+
+        t0 = BenchClock::now();
+        float d = contractionHierarchyQuery(ch, s, t, space, path);
+        chMs += elapsedMs(t0);
+        if (d != dist[t] || path != expected) ++mismatches;
+    }
+    cout << "Dijkstra: " << dijkstraMs / queries << " ms/query\n";
+    cout << "CH:       " << chMs / queries << " ms/query (" << dijkstraMs / max(1e-9, chMs) << "x faster)\n";
+    cout << "Distance/path mismatches: " << mismatches << "\n";
+}
+
+// Single-core and pooled throughput of the CSV loaders.
+void benchCsvIngestion(int n, NetworkShape shape) {
+    const string centersFile = "bench_health_centers.csv", connectionsFile = "bench_connections.csv";
+    generateSyntheticNetwork(n, shape, 42);
+    saveHealthCenters(centersFile);
+    saveConnections(connectionsFile);
+    error_code ec;
+    double megabytes = (filesystem::file_size(centersFile, ec) + filesystem::file_size(connectionsFile, ec)) / 1e6;
+
+    cout << fixed << setprecision(1);
+    cout << "CSV ingestion of " << n << " centers (" << megabytes << " MB):\n";
+    for (bool parallel : {false, true}) {
+        centers.clear();
+        adjList.clear();
+        clearDescriptions();
+        clearNodes();
+        auto t0 = BenchClock::now();
+        readHealthCenters(centersFile, parallel);
+        readConnections(connectionsFile, parallel);
+        double ms = elapsedMs(t0);
+        cout << (parallel ? "Worker pool (" + to_string(workerPool().size()) + " threads): " : "Single core: ")
+             << ms << " ms, " << megabytes / (ms / 1000) << " MB/s, " << centers.size() << " centers, "
+             << network.numEdges() / 2 << " connections\n";
+    }
+    for (const string& name : {centersFile, connectionsFile}) remove(name.c_str());
+}
+
+// Startup cost of parsing the CSV files against mapping a snapshot.
+void benchStartup(int n, NetworkShape shape) {
+    const string centersFile = "bench_health_centers.csv", connectionsFile = "bench_connections.csv";
+    const string snapshotName = "bench_network.snapshot";
+    generateSyntheticNetwork(n, shape, 42);
+    saveHealthCenters(centersFile);
+    saveConnections(connectionsFile);
+    uint64_t stamp = csvStamp(centersFile, connectionsFile);
+
+    // Reload from the CSV text so both paths describe identical data.
+    centers.clear();
+    adjList.clear();
+    clearDescriptions();
+    clearNodes();
+    auto t0 = BenchClock::now();
+    readHealthCenters(centersFile);
+    readConnections(connectionsFile);
+    double csvMs = elapsedMs(t0);
+    uint64_t csvFingerprint = networkFingerprint(graph());
+    writeSnapshot(snapshotName, stamp);
+
+    t0 = BenchClock::now();
+    bool loaded = loadSnapshot(snapshotName, stamp);
+    double snapshotMs = elapsedMs(t0);
+    bool same = loaded && networkFingerprint(graph()) == csvFingerprint;
+
+    cout << fixed << setprecision(3);
+    cout << "Startup with " << n << " centers and " << network.numEdges() / 2 << " connections:\n";
+    cout << "CSV parsing:     " << csvMs << " ms\n";
+    cout << "Snapshot mmap:   " << snapshotMs << " ms (" << csvMs / max(1e-9, snapshotMs) << "x faster)\n";
+    cout << "Networks identical: " << (same ? "yes" : "no") << "\n";
+    adjacencyPending = false;
+    snapshotFile.close();
+    for (const string& name : {centersFile, connectionsFile, snapshotName}) remove(name.c_str());
 }
 
-void saveConnections(const string& filename) {
-    ofstream file(filename);
-    file << "FromID,ToID,DistanceKM,TimeMinutes,Description\n";
-    set<pair<int, int>> written; // To avoid duplicate edges
-    for (int i = 0; i < MAX; ++i) {
-        for (const auto& c : adjList[i]) {
-            if (written.find({min(i, c.to), max(i, c.to)}) == written.end()) {
-                file << i << "," << c.to << "," << fixed << setprecision(2) << c.distance << "," << c.time << "," << c.description << "\n";
-                written.insert({min(i, c.to), max(i, c.to)});
+// Dijkstra with each priority queue on every network shape, checking that
+// all three agree on the distances.
+void benchQueues(int n, int queries) {
+    const char* names[] = {"binary heap", "4-ary heap", "radix heap"};
+    double totals[3] = {};
+    for (int shapeIndex = 0; shapeIndex < 3; ++shapeIndex) {
+        generateSyntheticNetwork(n, (NetworkShape)shapeIndex, 42);
+        const CSRGraph& g = graph();
+        mt19937 rng(7);
+        vector<int> sources(queries);
+        for (int& s : sources) s = rng() % n;
+
+        vector<float> dist, expected;
+        vector<int> prev;
+        int mismatches = 0;
+        auto run = [&](int which, auto& pq) {
+            auto t0 = BenchClock::now();
+            for (int s : sources) dijkstraCore(g, s, dist, prev, pq);
+            double ms = elapsedMs(t0) / queries;
+            totals[which] += ms;
+            dijkstraCore(g, sources[0], dist, prev, pq);
+            if (expected.empty()) expected = dist;
+            for (int v = 0; v < n; ++v) {
+                if (fabs(dist[v] - expected[v]) > 1e-3f * max(1.0f, expected[v])) ++mismatches;
             }
-        }
+            cout << "  " << left << setw(12) << names[which] << right << setw(10) << ms << " ms/query\n";
+        };
+        cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[shapeIndex] << " (" << n << " centers):\n";
+        LazyBinaryHeap binary;
+        QuaternaryHeap quaternary;
+        RadixHeap radix;
+        run(0, binary);
+        run(1, quaternary);
+        run(2, radix);
+        cout << "  distance mismatches: " << mismatches << "\n";
     }
-    file.close();
+    int best = min_element(totals, totals + 3) - totals;
+    cout << "Fastest over all shapes: " << names[best] << "\n";
 }
 
-// CRUD Operations
-void addHealthCenter() {
-    HealthCenter hc;
-    string idStr, capacityStr;
-    cout << "Enter ID: "; cin >> idStr;
-    if (!isNumber(idStr)) {
-        cout << "Error: ID must be a number.\n";
-        return;
-    }
-    hc.id = stoi(idStr);
-    for (const auto& center : centers) {
-        if (center.id == hc.id) {
-            cout << "ID already exists!\n";
-            return;
+// Queue BFS against the direction-optimizing engine, serial and pooled, for
+// full traversals from single sources and for a many-source "within 3 hops"
+// sweep. Hop counts are checked against the queue BFS tree.
+void benchHops(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    mt19937 rng(7);
+    vector<int> sources(queries);
+    for (int& s : sources) s = rng() % n;
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections\n";
+
+    vector<int> order, expected(n);
+    QueryContext qc;
+    HopSearch ws;
+    double queueMs = 0, serialMs = 0, pooledMs = 0;
+    int mismatches = 0;
+    for (int s : sources) {
+        auto t0 = BenchClock::now();
+        bfsOrder(g, s, qc, order);
+        queueMs += elapsedMs(t0);
+        fill(expected.begin(), expected.end(), -1);
+        expected[s] = 0;
+        for (int v : order) {
+            if (v != s) expected[v] = expected[qc.prev[v]] + 1;
+        }
+        for (bool parallel : {false, true}) {
+            t0 = BenchClock::now();
+            hopDistances(g, {s}, -1, ws, parallel);
+            (parallel ? pooledMs : serialMs) += elapsedMs(t0);
+            if (ws.hops != expected) ++mismatches;
         }
     }
-    cout << "Enter Name: "; cin.ignore(); getline(cin, hc.name);
-    cout << "Enter District: "; getline(cin, hc.district);
-    cout << "Enter Latitude: "; cin >> hc.lat;
-    cout << "Enter Longitude: "; cin >> hc.lon;
-    cout << "Enter Capacity: "; cin >> capacityStr;
-    if (!isNumber(capacityStr)) {
-        cout << "Error: Capacity must be a number.\n";
-        return;
+    cout << "Single source, full traversal:\n";
+    cout << "  queue BFS:          " << queueMs / queries << " ms/query\n";
+    cout << "  direction-opt:      " << serialMs / queries << " ms/query\n";
+    cout << "  direction-opt (" << workerPool().size() << "t): " << pooledMs / queries << " ms/query\n";
+
+    vector<int> outbreak(min(n, 1000));
+    for (int& s : outbreak) s = rng() % n;
+    for (int maxHops : {3, -1}) {
+        for (bool parallel : {false, true}) {
+            auto t0 = BenchClock::now();
+            int reached = hopDistances(g, outbreak, maxHops, ws, parallel);
+            cout << (parallel ? "  pooled" : "  serial") << " sweep from " << outbreak.size() << " sources, "
+                 << (maxHops < 0 ? string("no hop limit") : "within " + to_string(maxHops) + " hops") << ": "
+                 << elapsedMs(t0) << " ms, " << reached << " centers reached\n";
+        }
     }
-    hc.capacity = stoi(capacityStr);
-    centers.push_back(hc);
-    saveHealthCenters("health_centers.csv");
-    cout << "Health center added.\n";
+    cout << "Hop count mismatches: " << mismatches << "\n";
 }
 
-void editHealthCenter(int id) {
-    for (auto& hc : centers) {
-        if (hc.id == id) {
-            cout << "Editing Health Center ID " << id << "\n";
-            cout << "Enter new Name (current: " << hc.name << "): ";
-            cin.ignore(); getline(cin, hc.name);
-            cout << "Enter new District (current: " << hc.district << "): ";
-            getline(cin, hc.district);
-            cout << "Enter new Latitude (current: " << hc.lat << "): ";
-            cin >> hc.lat;
-            cout << "Enter new Longitude (current: " << hc.lon << "): ";
-            cin >> hc.lon;
-            string capacityStr;
-            cout << "Enter new Capacity (current: " << hc.capacity << "): ";
-            cin >> capacityStr;
-            if (!isNumber(capacityStr)) {
-                cout << "Error: Capacity must be a number.\n";
-                return;
-            }
-            hc.capacity = stoi(capacityStr);
-            saveHealthCenters("health_centers.csv");
-            cout << "Health center updated.\n";
-            return;
+// Random removals and additions checked against a BFS labelling of the
+// components. Each round removes connections (and now and then every
+// connection of a center), which leaves the index stale, rebuilds it once,
+// then folds new connections in through the union-find. The index must then
+// split the nodes exactly as the BFS does, with connections - nodes +
+// components cycle edges.
+void benchConnectivity(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << graph().numEdges() / 2 << " connections\n";
+    mt19937 rng(7);
+    vector<int> label(n), rootLabel(n), queue;
+    double rebuildMs = 0, addMs = 0;
+    int adds = 0, mismatches = 0;
+    for (int round = 0; round < queries; ++round) {
+        for (int r = 0; r < 4; ++r) {
+            int u = rng() % n;
+            if (adjList[u].empty()) continue;
+            if (r == 0 && round % 8 == 0) isolateNode(u);
+            else eraseConnectionAt(u, rng() % adjList[u].size());
+        }
+        auto t0 = BenchClock::now();
+        connectivityIndex();
+        rebuildMs += elapsedMs(t0);
+        for (int a = 0; a < 4; ++a) {
+            int u = rng() % n, v = rng() % n;
+            t0 = BenchClock::now();
+            insertConnection(u, v, 1.0f, 1, "Benchmark road");
+            addMs += elapsedMs(t0);
+            ++adds;
+        }
+
+        ConnectivityIndex& index = connectivityIndex();
+        fill(label.begin(), label.end(), -1);
+        int components = 0;
+        long long halfEdges = 0;
+        for (int s = 0; s < n; ++s) {
+            halfEdges += adjList[s].size();
+            if (label[s] >= 0) continue;
+            label[s] = components;
+            queue.assign(1, s);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                for (const Connection& c : adjList[queue[head]]) {
+                    if (label[c.to] < 0) {
+                        label[c.to] = components;
+                        queue.push_back(c.to);
+                    }
+                }
+            }
+            ++components;
+        }
+        // Same partition: every root maps to one BFS label and vice versa.
+        fill(rootLabel.begin(), rootLabel.end(), -1);
+        int roots = 0;
+        bool same = index.cycleEdges == halfEdges / 2 - n + components;
+        for (int v = 0; v < n && same; ++v) {
+            int root = index.sets.find(v);
+            if (rootLabel[root] < 0) {
+                rootLabel[root] = label[v];
+                ++roots;
+            }
+            same = rootLabel[root] == label[v];
         }
+        if (!same || roots != components) ++mismatches;
     }
-    cout << "Health center with ID " << id << " not found.\n";
+    cout << "Rebuild after removals: " << rebuildMs / queries << " ms, incremental add: " << addMs * 1000 / max(1, adds)
+         << " us\n";
+    cout << "Mismatches vs BFS components: " << mismatches << " of " << queries << " rounds\n";
 }
 
-void viewHealthCenters() {
-    if (centers.empty()) {
-        cout << "No health centers available.\n";
-        return;
+// Grid kNN and radius queries against a linear scan of centers, plus the
+// cost of moving centers around the index.
+void benchSpatial(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    auto t0 = BenchClock::now();
+    spatialIndex();
+    double buildMs = elapsedMs(t0);
+    cout << fixed << setprecision(4) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n
+         << " centers, index built in " << buildMs << " ms (" << centerGrid.cells.size() << " cells)\n";
+
+    mt19937 rng(7);
+    uniform_real_distribution<float> latDist(SYNTHETIC_LAT_MIN - 0.1f, SYNTHETIC_LAT_MIN + SYNTHETIC_SPAN + 0.1f);
+    uniform_real_distribution<float> lonDist(SYNTHETIC_LON_MIN - 0.1f, SYNTHETIC_LON_MIN + SYNTHETIC_SPAN + 0.1f);
+    const int k = 8;
+    const float radiusKm = 5;
+    double gridMs = 0, radiusMs = 0, scanMs = 0;
+    int mismatches = 0;
+    vector<pair<float, int>> all(n);
+    for (int q = 0; q < queries; ++q) {
+        float la = latDist(rng), lo = lonDist(rng);
+        t0 = BenchClock::now();
+        vector<pair<float, int>> nearest = nearestCenters(la, lo, k);
+        gridMs += elapsedMs(t0);
+        t0 = BenchClock::now();
+        vector<pair<float, int>> within = centersWithinRadius(la, lo, radiusKm);
+        radiusMs += elapsedMs(t0);
+
+        t0 = BenchClock::now();
+        for (int i = 0; i < n; ++i) all[i] = {haversineKm(la, lo, centers[i].lat, centers[i].lon), centers[i].node};
+        partial_sort(all.begin(), all.begin() + k, all.end());
+        scanMs += elapsedMs(t0);
+        if (!equal(nearest.begin(), nearest.end(), all.begin())) ++mismatches;
+        int expected = count_if(all.begin(), all.end(), [&](const pair<float, int>& e) { return e.first <= radiusKm; });
+        if ((int)within.size() != expected) ++mismatches;
     }
-    cout << "\nHealth Centers:\n";
-    cout << "ID  | Name                  | District      | Latitude | Longitude | Capacity\n";
-    cout << "----|-----------------------|---------------|----------|-----------|---------\n";
-    for (const auto& hc : centers) {
-        cout << left << setw(4) << hc.id << "| "
-             << setw(22) << hc.name.substr(0, 21) << "| "
-             << setw(14) << hc.district.substr(0, 13) << "| "
-             << fixed << setprecision(4) << setw(8) << hc.lat << "| "
-             << setw(9) << hc.lon << "| "
-             << hc.capacity << "\n";
+    cout << "Grid " << k << "-nearest:      " << gridMs / queries << " ms/query\n";
+    cout << "Grid " << radiusKm << " km radius:  " << radiusMs / queries << " ms/query\n";
+    cout << "Linear scan " << k << "-nearest: " << scanMs / queries << " ms/query\n";
+
+    t0 = BenchClock::now();
+    for (int q = 0; q < queries; ++q) {
+        HealthCenter& hc = centers[rng() % n];
+        hc.lat = latDist(rng);
+        hc.lon = lonDist(rng);
+        updateCenterInSpatialIndex(hc.node, &hc);
     }
+    cout << "Incremental move: " << elapsedMs(t0) * 1000 / queries << " us/center\n";
+    cout << "Mismatches vs linear scan: " << mismatches << "\n";
 }
 
-void removeHealthCenter(int id) {
-    auto it = remove_if(centers.begin(), centers.end(), [id](const HealthCenter& hc) {
-        return hc.id == id;
-    });
-    if (it == centers.end()) {
-        cout << "Health center not found.\n";
-        return;
-    }
-    centers.erase(it, centers.end());
-    adjList[id].clear();
-    for (int i = 0; i < MAX; ++i) {
-        adjList[i].erase(remove_if(adjList[i].begin(), adjList[i].end(), [id](const Connection& c) {
-            return c.to == id;
-        }), adjList[i].end());
+// Fastest-route Dijkstra on minutes and the Pareto search on both criteria,
+// checking that the ends of each Pareto front match the single-criterion
+// optima.
+void benchPareto(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    mt19937 rng(7);
+    vector<float> km, minutes;
+    vector<int> prev;
+    ParetoSearch ws;
+    vector<ParetoRoute> routes;
+    double dijkstraMs = 0, fastestMs = 0, paretoMs = 0;
+    long long frontSize = 0, labels = 0, popped = 0;
+    int answered = 0, mismatches = 0, truncated = 0;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n, t = rng() % n;
+        auto t0 = BenchClock::now();
+        dijkstraSearch(g, s, km, prev);
+        dijkstraMs += elapsedMs(t0);
+        t0 = BenchClock::now();
+        fastestSearch(g, s, minutes, prev);
+        fastestMs += elapsedMs(t0);
+        if (km[t] == INF) continue;
+
+        t0 = BenchClock::now();
+        if (!paretoRoutes(g, s, t, ws, routes)) ++truncated;
+        paretoMs += elapsedMs(t0);
+        ++answered;
+        frontSize += routes.size();
+        labels += ws.labels.size();
+        popped += ws.popped;
+        if (routes.empty() || fabs(routes.front().distance - km[t]) > 1e-3f * max(1.0f, km[t]) ||
+            (float)routes.back().time != minutes[t]) {
+            ++mismatches;
+        }
     }
-    saveHealthCenters("health_centers.csv");
-    saveConnections("connections.csv");
-    cout << "Health center removed.\n";
+    answered = max(1, answered);
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections\n";
+    cout << "Dijkstra (km):      " << dijkstraMs / queries << " ms/query\n";
+    cout << "Dijkstra (minutes): " << fastestMs / queries << " ms/query\n";
+    cout << "Pareto search:      " << paretoMs / answered << " ms/query, " << (double)frontSize / answered
+         << " routes/front, " << (double)labels / answered << " labels created, " << (double)popped / answered
+         << " settled\n";
+    cout << "Front end mismatches: " << mismatches << ", searches at label limit: " << truncated << "\n";
 }
 
-void addConnection(int from, int to, float distance, int time, const string& desc) {
-    bool fromExists = false, toExists = false;
-    for (const auto& hc : centers) {
-        if (hc.id == from) fromExists = true;
-        if (hc.id == to) toExists = true;
-    }
-    if (!fromExists || !toExists) {
-        cout << "Invalid health center ID(s).\n";
-        return;
-    }
-    for (const auto& c : adjList[from]) {
-        if (c.to == to) {
-            cout << "Connection already exists.\n";
-            return;
+// Prim from one center against the Kruskal and Boruvka forests on a sparse
+// (4 nearest neighbours) and a dense (32 nearest neighbours) network.
+void benchSpanningForest(int n, NetworkShape shape) {
+    for (int neighbours : {4, 32}) {
+        generateSyntheticNetwork(n, shape, 42, neighbours);
+        const CSRGraph& g = graph();
+        cout << fixed << setprecision(1);
+        cout << (neighbours == 4 ? "Sparse" : "Dense") << " network: " << n << " centers, " << g.numEdges() / 2 << " connections\n";
+
+        QueryContext qc;
+        auto t0 = BenchClock::now();
+        primTree(g, 0, qc);
+        double primMs = elapsedMs(t0);
+        double primCost = 0;
+        int primEdges = 0;
+        for (int v = 0; v < n; ++v) {
+            if (qc.parent(v) != -1) {
+                primCost += qc.dist[v];
+                ++primEdges;
+            }
         }
+        cout << "  primMST:           " << setw(9) << primMs << " ms, " << primEdges << " edges, cost " << primCost << " km (component of center 0)\n";
+
+        vector<ForestEdge> forest;
+        double reference = -1;
+        auto run = [&](const string& name, const function<float()>& build) {
+            t0 = BenchClock::now();
+            build();
+            double ms = elapsedMs(t0);
+            double cost = 0;
+            for (const ForestEdge& e : forest) cost += e.w;
+            if (reference < 0) reference = cost;
+            bool same = fabs(cost - reference) <= 1e-6 * max(1.0, reference);
+            cout << "  " << left << setw(19) << name + ":" << right << setw(9) << ms << " ms, " << forest.size()
+                 << " edges, cost " << cost << " km, " << n - forest.size() << " trees" << (same ? "" : " MISMATCH") << "\n";
+        };
+        run("kruskal", [&] { return kruskalForest(g, forest); });
+        run("boruvka", [&] { return boruvkaForest(g, forest, false); });
+        run("boruvka (" + to_string(workerPool().size()) + " thr)", [&] { return boruvkaForest(g, forest, true); });
     }
-    adjList[from].push_back({to, distance, time, desc});
-    adjList[to].push_back({from, distance, time, desc}); // Undirected
-    saveConnections("connections.csv");
-    cout << "Connection added.\n";
 }
 
-void editConnection(int from, int to) {
-    bool found = false;
-    for (auto& c : adjList[from]) {
-        if (c.to == to) {
-            cout << "Editing Connection from " << from << " to " << to << "\n";
-            cout << "Enter new DistanceKM (current: " << c.distance << "): ";
-            cin >> c.distance;
-            cout << "Enter new TimeMinutes (current: " << c.time << "): ";
-            cin >> c.time;
-            cout << "Enter new Description (current: " << c.description << "): ";
-            cin.ignore(); getline(cin, c.description);
-            found = true;
-            break;
+// Places patients spread over 50 casualty sites in centers with 1-4 beds,
+// once from scratch and once in ten waves that each re-solve from the
+// previous flow, and checks that both reach the same total distance.
+void benchCasualty(int n, int patients, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    mt19937 rng(7);
+    for (auto& hc : centers) hc.capacity = 1 + rng() % 4;
+    const CSRGraph& g = graph();
+    const int sites = 50, waves = 10;
+    vector<pair<int, int>> arrivals; // (site, patients) in arrival order
+    for (int w = 0; w < waves; ++w) {
+        int share = patients / waves + (w < patients % waves);
+        for (int i = 0; i < sites; ++i) {
+            int count = share / sites + (i < share % sites);
+            if (count > 0) arrivals.push_back({(int)(rng() % n), count});
         }
     }
-    if (!found) {
-        cout << "Connection from " << from << " to " << to << " not found.\n";
-        return;
-    }
-    for (auto& c : adjList[to]) {
-        if (c.to == from) {
-            cout << "Enter new DistanceKM (current: " << c.distance << "): ";
-            cin >> c.distance;
-            cout << "Enter new TimeMinutes (current: " << c.time << "): ";
-            cin >> c.time;
-            cout << "Enter new Description (current: " << c.description << "): ";
-            cin.ignore(); getline(cin, c.description);
-            break;
+    cout << fixed << setprecision(1) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections, " << patients << " patients\n";
+
+    CasualtyFlow cf;
+    auto t0 = BenchClock::now();
+    resetCasualtyFlow(cf, g);
+    for (const auto& a : arrivals) addCasualties(cf, a.first, a.second);
+    long long placed = solveCasualtyFlow(cf, g);
+    double scratchMs = elapsedMs(t0);
+    long long cost = casualtyCostMetres(cf);
+    cout << "From scratch: " << scratchMs << " ms, placed " << placed << ", " << cost / 1000.0 << " patient-km\n";
+
+    t0 = BenchClock::now();
+    resetCasualtyFlow(cf, g);
+    long long incrementalPlaced = 0;
+    double slowestWave = 0;
+    size_t next = 0;
+    for (int w = 0; w < waves; ++w) {
+        auto waveStart = BenchClock::now();
+        for (int i = 0; i < sites && next < arrivals.size(); ++i, ++next) {
+            addCasualties(cf, arrivals[next].first, arrivals[next].second);
         }
+        incrementalPlaced += solveCasualtyFlow(cf, g);
+        slowestWave = max(slowestWave, elapsedMs(waveStart));
+    }
+    double incrementalMs = elapsedMs(t0);
+    long long incrementalCost = casualtyCostMetres(cf);
+    cout << "In " << waves << " waves: " << incrementalMs << " ms (slowest wave " << slowestWave << " ms), placed "
+         << incrementalPlaced << ", " << incrementalCost / 1000.0 << " patient-km\n";
+    if (incrementalPlaced < patients) {
+        cout << "Not every patient was placed, so earlier waves may hold beds a from-scratch solve gives away.\n";
+    } else {
+        cout << "Cost mismatch: " << (incrementalCost == cost ? "none" : "YES") << "\n";
     }
-    saveConnections("connections.csv");
-    cout << "Connection updated.\n";
 }
 
-void viewConnections() {
-    set<pair<int, int>> displayed;
-    bool hasConnections = false;
-    cout << "\nConnections:\n";
-    cout << "FromID | ToID | DistanceKM | TimeMinutes | Description\n";
-    cout << "-------|------|------------|-------------|------------\n";
-    for (int i = 0; i < MAX; ++i) {
-        for (const auto& c : adjList[i]) {
-            if (displayed.find({min(i, c.to), max(i, c.to)}) == displayed.end()) {
-                cout << left << setw(7) << i << "| "
-                     << setw(5) << c.to << "| "
-                     << fixed << setprecision(2) << setw(10) << c.distance << "| "
-                     << setw(11) << c.time << "| "
-                     << c.description << "\n";
-                displayed.insert({min(i, c.to), max(i, c.to)});
-                hasConnections = true;
-            }
+// Yen's k shortest routes between random centers: latency, spur searches run
+// and skipped by the k-th best bound, and checks that the first route matches
+// Dijkstra and later ones never get shorter.
+void benchKShortest(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    const int k = 10;
+    mt19937 rng(7);
+    KPathSearch ws;
+    vector<AlternativeRoute> routes;
+    vector<float> dist, expected;
+    vector<int> prev;
+    double ms = 0;
+    long long found = 0, searches = 0, pruned = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n, t = rng() % n;
+        dijkstraSearch(g, s, dist, prev);
+        auto t0 = BenchClock::now();
+        kShortestRoutes(g, s, t, k, ws, routes);
+        ms += elapsedMs(t0);
+        found += routes.size();
+        searches += ws.spurSearches;
+        pruned += ws.spursPruned;
+        if (dist[t] == INF ? !routes.empty() : routes.empty() || fabs(routes[0].distance - dist[t]) > 1e-3f * max(1.0f, dist[t])) {
+            ++mismatches;
+        }
+        for (size_t r = 1; r < routes.size(); ++r) {
+            if (routes[r].distance < routes[r - 1].distance - 1e-3f) ++mismatches;
         }
     }
-    if (!hasConnections) {
-        cout << "No connections available.\n";
-    }
-}
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections, k = " << k << "\n";
+    cout << "Yen: " << ms / queries << " ms/query, " << (double)found / queries << " routes, "
+         << (double)searches / queries << " spur searches and " << (double)pruned / queries << " spurs skipped per query\n";
+    cout << "Mismatches: " << mismatches << "\n";
 
-void viewRelationships() {
-    ofstream out("relationship_table.csv");
-    out << "HealthCenter,ConnectedCenters,Description\n";
-    cout << "\nHealth Center | Connected Centers        | Description\n";
-    cout << "--------------|-------------------------|-------------------\n";
-    for (const auto& hc : centers) {
-        string links;
-        for (const auto& c : adjList[hc.id]) {
-            links += to_string(c.to) + "(" + c.description + ") ";
+    // Brute force on small networks: a DFS lists every loopless arc sequence
+    // from s to t, and Yen's routes must be simple, start and end at s and t,
+    // and have the k smallest of those distances.
+    const int smallNetworks = 200, smallCenters = 10;
+    int bruteMismatches = 0;
+    vector<float> all;
+    vector<char> onPath(smallCenters);
+    function<void(int, int, float)> enumerate = [&](int u, int t, float d) {
+        const CSRGraph& sg = network;
+        if (u == t) {
+            all.push_back(d);
+            return;
         }
-        if (links.empty()) links = "None";
-        string desc = hc.description();
-        cout << left << setw(14) << hc.id << "| " << setw(24) << links.substr(0, 23) << "| " << desc << "\n";
-        out << hc.id << "," << links << "," << desc << "\n";
+        onPath[u] = 1;
+        for (int e = sg.offsets[u]; e < sg.offsets[u + 1]; ++e) {
+            if (!onPath[sg.targets[e]]) enumerate(sg.targets[e], t, d + sg.weights[e]);
+        }
+        onPath[u] = 0;
+    };
+    for (int seed = 1; seed <= smallNetworks; ++seed) {
+        generateSyntheticNetwork(smallCenters, shape, seed);
+        const CSRGraph& sg = graph();
+        int s = rng() % smallCenters, t = rng() % smallCenters;
+        all.clear();
+        enumerate(s, t, 0);
+        sort(all.begin(), all.end());
+        kShortestRoutes(sg, s, t, k, ws, routes);
+        bool same = routes.size() == min(all.size(), (size_t)k);
+        for (size_t r = 0; r < routes.size() && same; ++r) {
+            const vector<int>& path = routes[r].path;
+            vector<int> sorted = path;
+            sort(sorted.begin(), sorted.end());
+            same = path.front() == s && path.back() == t && adjacent_find(sorted.begin(), sorted.end()) == sorted.end() &&
+                   fabs(routes[r].distance - all[r]) <= 1e-3f * max(1.0f, all[r]);
+        }
+        if (!same) ++bruteMismatches;
     }
-    out.close();
-    cout << "\nRelationship table saved to 'relationship_table.csv'.\n";
+    cout << "Mismatches vs brute force on " << smallNetworks << " networks of " << smallCenters
+         << " centers: " << bruteMismatches << "\n";
 }
 
-void removeConnection(int from, int to) {
-    auto it = remove_if(adjList[from].begin(), adjList[from].end(), [to](const Connection& c) {
-        return c.to == to;
-    });
-    if (it == adjList[from].end()) {
-        cout << "Connection not found.\n";
-        return;
+// Point-to-point queries between centers a short random walk apart, as a
+// dispatcher's local lookups are: a full Dijkstra into fresh arrays against
+// the early-stopping search on a reused query context.
+void benchLocalQueries(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n, t = s;
+        for (int step = 0; step < 20 && g.degree(t) > 0; ++step) {
+            t = g.targets[g.offsets[t] + rng() % g.degree(t)];
+        }
+        pairs.push_back({s, t});
     }
-    adjList[from].erase(it, adjList[from].end());
-    adjList[to].erase(remove_if(adjList[to].begin(), adjList[to].end(), [from](const Connection& c) {
-        return c.to == from;
-    }), adjList[to].end());
-    saveConnections("connections.csv");
-    cout << "Connection removed.\n";
+    double freshMs = 0, contextMs = 0;
+    long long contextSettled = 0;
+    int mismatches = 0;
+    QueryContext& qc = queryContext();
+    for (const auto& [s, t] : pairs) {
+        auto t0 = BenchClock::now();
+        vector<float> dist;
+        vector<int> prev;
+        dijkstraSearch(g, s, dist, prev);
+        freshMs += elapsedMs(t0);
+        t0 = BenchClock::now();
+        contextSettled += dijkstraQuery(g, s, t, qc);
+        contextMs += elapsedMs(t0);
+        if (qc.distance(t) != dist[t]) ++mismatches;
+    }
+    cout << fixed << setprecision(4) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, targets 20 steps away\n";
+    cout << "Full Dijkstra, fresh arrays:  " << freshMs / queries << " ms/query\n";
+    cout << "Stop at target, reused context: " << contextMs / queries << " ms/query, "
+         << (double)contextSettled / queries << " settled/query (" << freshMs / max(1e-9, contextMs) << "x faster)\n";
+    cout << "Distance mismatches: " << mismatches << "\n";
 }
 
-// Graph Algorithms
-void dijkstra(int start, int end) {
-    vector<float> dist(MAX, INF);
-    vector<int> prev(MAX, -1);
-    dist[start] = 0;
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
-    pq.push({0, start});
+// Hub label preprocessing, size and query latency against the contraction
+// hierarchy and Dijkstra, plus one-to-many lookups over 200 candidates and a
+// save/load round trip.
+void benchHubLabels(int n, int queries, NetworkShape shape) {
+    const string filename = "bench_network.hl";
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    auto t0 = BenchClock::now();
+    ContractionHierarchy ch;
+    buildContractionHierarchy(g, ch);
+    double chMs = elapsedMs(t0);
+    t0 = BenchClock::now();
+    HubLabels hl;
+    buildHubLabels(g, ch, hl);
+    double buildMs = elapsedMs(t0);
+    size_t entries = 0;
+    for (uint32_t hub : hl.hubs) entries += hub != HUB_PAD;
+    size_t bytes = hl.offsets.size() * sizeof(int) + hl.hubs.size() * (sizeof(uint32_t) + sizeof(float));
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections\n";
+    cout << "Preprocessing: CH " << chMs << " ms, labels " << buildMs << " ms, " << (double)entries / n
+         << " hubs/label, " << bytes / 1048576.0 << " MiB\n";
 
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        float d = pq.top().first;
-        pq.pop();
-        if (d > dist[u]) continue;
-        for (const auto& c : adjList[u]) {
-            if (dist[c.to] > dist[u] + c.distance) {
-                dist[c.to] = dist[u] + c.distance;
-                prev[c.to] = u;
-                pq.push({dist[c.to], c.to});
-            }
-        }
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& p : pairs) p = {(int)(rng() % n), (int)(rng() % n)};
+    vector<float> dist, simd(queries), scalar(queries);
+    vector<int> prev, path;
+    CHQuerySpace space;
+    double dijkstraMs = 0, chQueryMs = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        auto [s, t] = pairs[q];
+        t0 = BenchClock::now();
+        dijkstraSearch(g, s, dist, prev);
+        dijkstraMs += elapsedMs(t0);
+        t0 = BenchClock::now();
+        contractionHierarchyQuery(ch, s, t, space, path);
+        chQueryMs += elapsedMs(t0);
+        float d = hubDistance(hl, s, t);
+        if (fabs(min(d, INF) - dist[t]) > 1e-3f * max(1.0f, dist[t])) ++mismatches;
     }
+    // Label lookups are too quick to time one by one.
+    t0 = BenchClock::now();
+    for (int q = 0; q < queries; ++q) scalar[q] = hubDistanceScalar(hl, pairs[q].first, pairs[q].second);
+    double scalarMs = elapsedMs(t0);
+    t0 = BenchClock::now();
+    for (int q = 0; q < queries; ++q) simd[q] = hubDistance(hl, pairs[q].first, pairs[q].second);
+    double simdMs = elapsedMs(t0);
+    for (int q = 0; q < queries; ++q) mismatches += simd[q] != scalar[q];
+    cout << "Dijkstra:          " << dijkstraMs * 1000 / queries << " us/query\n";
+    cout << "CH:                " << chQueryMs * 1000 / queries << " us/query\n";
+    cout << "Labels (scalar):   " << scalarMs * 1000 / queries << " us/query\n";
+    cout << "Labels (SIMD):     " << simdMs * 1000 / queries << " us/query\n";
 
-    if (dist[end] == INF) {
-        cout << "No path from " << start << " to " << end << ".\n";
-        return;
+    vector<int> candidates(min(n, 200));
+    vector<float> found, table;
+    long long manyMismatches = 0;
+    t0 = BenchClock::now();
+    for (int q = 0; q < queries; ++q) {
+        for (int& c : candidates) c = rng() % n;
+        hubDistances(hl, pairs[q].first, candidates, found, table);
+        for (size_t c = 0; c < candidates.size(); c += 37) manyMismatches += found[c] != hubDistance(hl, pairs[q].first, candidates[c]);
     }
+    cout << "One to " << candidates.size() << " candidates: " << elapsedMs(t0) / queries << " ms/query\n";
 
-    cout << "Shortest Distance from " << start << " to " << end << ": " << dist[end] << " km\n";
-    cout << "Path: ";
-    vector<int> path;
-    for (int at = end; at != -1; at = prev[at]) path.push_back(at);
-    for (int i = path.size() - 1; i >= 0; --i) cout << path[i] << (i > 0 ? " -> " : "\n");
+    saveHubLabels(hl, filename);
+    HubLabels loaded;
+    t0 = BenchClock::now();
+    bool ok = loadHubLabels(loaded, filename, networkFingerprint(g));
+    double loadMs = elapsedMs(t0);
+    ok = ok && loaded.offsets == hl.offsets && loaded.hubs == hl.hubs && loaded.dists == hl.dists;
+    remove(filename.c_str());
+    cout << "Reload: " << loadMs << " ms, " << (ok ? "identical" : "DIFFERENT") << "\n";
+    cout << "Mismatches: " << mismatches + manyMismatches << "\n";
 }
 
-void bfs(int start) {
-    vector<bool> visited(MAX, false);
-    queue<int> q;
-    visited[start] = true;
-    q.push(start);
-    cout << "BFS Traversal: ";
-    while (!q.empty()) {
-        int u = q.front(); q.pop();
-        cout << u << " ";
-        for (const auto& c : adjList[u]) {
-            if (!visited[c.to]) {
-                visited[c.to] = true;
-                q.push(c.to);
-            }
-        }
+// Landmark selection and table build for both strategies, then point-to-point
+// queries with Dijkstra stopped at the target, straight-line A* and ALT.
+void benchLandmarks(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections, " << workerPool().size() << " threads\n";
+    mt19937 rng(7);
+    vector<pair<int, int>> pairs(queries);
+    for (auto& p : pairs) p = {(int)(rng() % n), (int)(rng() % n)};
+    QueryContext qc;
+    vector<float> expected(queries);
+    long long dijkstraSettled = 0, aStarSettled = 0;
+    double dijkstraMs = 0, aStarMs = 0;
+    for (int q = 0; q < queries; ++q) {
+        auto t0 = BenchClock::now();
+        dijkstraSettled += dijkstraQuery(g, pairs[q].first, pairs[q].second, qc);
+        dijkstraMs += elapsedMs(t0);
+        expected[q] = qc.distance(pairs[q].second);
+        t0 = BenchClock::now();
+        aStarSettled += aStarSearch(g, pairs[q].first, pairs[q].second, qc);
+        aStarMs += elapsedMs(t0);
     }
-    cout << endl;
-}
+    cout << "Dijkstra:         " << (double)dijkstraSettled / queries << " settled, " << dijkstraMs / queries << " ms/query\n";
+    cout << "A* (straight):    " << (double)aStarSettled / queries << " settled, " << aStarMs / queries << " ms/query\n";
 
-bool dfsCycle(int u, int parent, vector<bool>& visited) {
-    visited[u] = true;
-    for (const auto& c : adjList[u]) {
-        if (!visited[c.to]) {
-            if (dfsCycle(c.to, u, visited)) return true;
-        } else if (c.to != parent) return true;
+    const string filename = "bench_network.alt";
+    vector<int> active;
+    for (LandmarkStrategy strategy : {LandmarkStrategy::Farthest, LandmarkStrategy::District}) {
+        auto t0 = BenchClock::now();
+        vector<int> chosen = strategy == LandmarkStrategy::Farthest ? farthestLandmarks(g, DEFAULT_LANDMARKS)
+                                                                    : districtLandmarks(DEFAULT_LANDMARKS);
+        double selectMs = elapsedMs(t0);
+        LandmarkTable table;
+        t0 = BenchClock::now();
+        buildLandmarkTable(g, chosen, table);
+        double buildMs = elapsedMs(t0);
+        saveLandmarkTable(table, filename);
+        LandmarkTable loaded;
+        bool same = loadLandmarkTable(loaded, filename, networkFingerprint(g), n) && loaded.dist == table.dist &&
+                    loaded.landmarks == table.landmarks;
+        remove(filename.c_str());
+
+        long long settled = 0;
+        int mismatches = 0;
+        t0 = BenchClock::now();
+        for (int q = 0; q < queries; ++q) {
+            settled += altSearch(g, table, pairs[q].first, pairs[q].second, qc, active);
+            float d = qc.distance(pairs[q].second);
+            if (fabs(d - expected[q]) > 1e-3f * max(1.0f, expected[q])) ++mismatches;
+        }
+        double altMs = elapsedMs(t0);
+        cout << "ALT (" << table.count() << " " << LANDMARK_STRATEGY_NAMES[(int)strategy] << "): " << (double)settled / queries
+             << " settled, " << altMs / queries << " ms/query; select " << selectMs << " ms, table " << buildMs << " ms, "
+             << table.dist.size() * sizeof(float) / 1048576.0 << " MiB, reload " << (same ? "identical" : "DIFFERENT")
+             << ", mismatches " << mismatches << "\n";
     }
-    return false;
 }
 
-void detectCycle() {
-    vector<bool> visited(MAX, false);
-    bool hasCycle = false;
-    for (int i = 0; i < MAX; ++i) {
-        if (!adjList[i].empty() && !visited[i]) {
-            if (dfsCycle(i, -1, visited)) {
-                hasCycle = true;
-                break;
-            }
+// Isochrone bands from random centers in one pass against a bounded search
+// per threshold, then the full coverage table on the worker pool.
+void benchIsochrones(int n, int queries, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    refreshCenterSlots();
+    const vector<int>& thresholds = DEFAULT_ISOCHRONE_MINUTES;
+    mt19937 rng(7);
+    QueryContext qc;
+    vector<IsochroneBand> bands, single;
+    double passMs = 0, separateMs = 0;
+    long long reached = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; ++q) {
+        int s = rng() % n;
+        auto t0 = BenchClock::now();
+        isochroneBands(g, s, thresholds, qc, bands);
+        passMs += elapsedMs(t0);
+        size_t total = 0;
+        for (size_t b = 0; b < bands.size(); ++b) {
+            total += bands[b].reached.size();
+            t0 = BenchClock::now();
+            isochroneBands(g, s, {thresholds[b]}, qc, single);
+            separateMs += elapsedMs(t0);
+            if (single[0].reached.size() != total) ++mismatches;
         }
+        reached += total;
     }
-    cout << (hasCycle ? "Cycle detected in the network.\n" : "No cycle found in the network.\n");
+    cout << fixed << setprecision(3) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections, bands 30/60/90 min\n";
+    cout << "One pass:          " << passMs / queries << " ms/query, " << (double)reached / queries << " centers within 90 min\n";
+    cout << "Search per band:   " << separateMs / queries << " ms/query\n";
+    cout << "Band size mismatches: " << mismatches << "\n";
+    coverageTable(thresholds, "bench_coverage_table.csv");
+    remove("bench_coverage_table.csv");
 }
 
-void floydWarshall(int numCenters) {
-    fwDistances.assign(MAX, vector<float>(MAX, INF));
-    for (int i = 0; i < MAX; ++i) fwDistances[i][i] = 0;
-
-    for (int i = 0; i < MAX; ++i) {
-        for (const auto& c : adjList[i]) {
-            fwDistances[i][c.to] = c.distance;
-            fwDistances[c.to][i] = c.distance;
-        }
+// Exact betweenness against estimates from growing source samples: the
+// largest normalised error seen next to its Hoeffding bound.
+void benchBetweenness(int n, NetworkShape shape) {
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    cout << fixed << setprecision(1) << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << n << " centers, "
+         << g.numEdges() / 2 << " connections, " << workerPool().size() << " threads\n";
+    double nodeScale = nodeBetweennessScale(n), arcScale = arcBetweennessScale(n) / 2; // Arc scores are half a connection's
+    Betweenness exact, estimate;
+    auto t0 = BenchClock::now();
+    computeBetweenness(g, 0, 1, exact);
+    cout << "Exact:        " << elapsedMs(t0) << " ms\n";
+    for (int samples : {n / 100, n / 20, n / 5}) {
+        if (samples < 1) continue;
+        t0 = BenchClock::now();
+        computeBetweenness(g, samples, 1, estimate);
+        double ms = elapsedMs(t0);
+        double nodeError = 0, arcError = 0;
+        for (int v = 0; v < n; ++v) nodeError = max(nodeError, fabs(estimate.node[v] - exact.node[v]) / nodeScale);
+        for (int e = 0; e < g.numEdges(); ++e) arcError = max(arcError, fabs(estimate.arc[e] - exact.arc[e]) / arcScale);
+        cout << setprecision(1) << samples << " sources: " << ms << " ms, max error " << setprecision(5) << nodeError
+             << " centers (bound " << estimate.nodeError << "), " << arcError << " arcs (bound " << estimate.arcError << ")\n";
     }
 
-    for (int k = 0; k < numCenters; ++k) {
-        for (int i = 0; i < numCenters; ++i) {
-            for (int j = 0; j < numCenters; ++j) {
-                if (fwDistances[i][k] != INF && fwDistances[k][j] != INF) {
-                    fwDistances[i][j] = min(fwDistances[i][j], fwDistances[i][k] + fwDistances[k][j]);
+    // Brute force on small networks: every simple path between every ordered
+    // pair of centers is listed by a DFS cut off at the pair's distance, and
+    // each node and arc earns its share of the shortest ones, halved as Brandes
+    // halves. Every other network also gets a connection endpoint with no
+    // center record, which paths may cross but never end at.
+    const int smallNetworks = 200, smallCenters = 10;
+    int bruteMismatches = 0;
+    vector<long long> metres;
+    vector<vector<long long>> apsp;
+    vector<double> node, arc;
+    vector<vector<int>> shortest; // Arc sequences of the shortest paths of one pair
+    vector<int> arcs;
+    vector<char> onPath(smallCenters + 1);
+    long long target = 0; // Distance of the pair being enumerated
+    function<void(int, int, long long)> enumerate = [&](int u, int t, long long d) {
+        const CSRGraph& sg = network;
+        if (u == t) {
+            shortest.push_back(arcs);
+            return;
+        }
+        onPath[u] = 1;
+        for (int e = sg.offsets[u]; e < sg.offsets[u + 1]; ++e) {
+            int v = sg.targets[e];
+            if (onPath[v] || d + metres[e] + apsp[v][t] > target) continue;
+            arcs.push_back(e);
+            enumerate(v, t, d + metres[e]);
+            arcs.pop_back();
+        }
+        onPath[u] = 0;
+    };
+    for (int seed = 1; seed <= smallNetworks; ++seed) {
+        generateSyntheticNetwork(smallCenters, shape, seed);
+        if (seed % 2 == 0) {
+            int extra = internNode(smallCenters);
+            insertConnection(extra, seed % smallCenters, 5.0f, 5, "Benchmark road");
+            if (seed % 4 == 0) insertConnection(extra, (seed / 4) % smallCenters, 1.0f, 1, "Benchmark road");
+        }
+        const CSRGraph& sg = graph();
+        int nodes = sg.numNodes(), m = sg.numEdges();
+        metres.resize(m);
+        for (int e = 0; e < m; ++e) metres[e] = llround((double)sg.weights[e] * 1000);
+        const long long unreached = numeric_limits<long long>::max() / 4;
+        apsp.assign(nodes, vector<long long>(nodes, unreached));
+        for (int u = 0; u < nodes; ++u) {
+            apsp[u][u] = 0;
+            for (int e = sg.offsets[u]; e < sg.offsets[u + 1]; ++e) apsp[u][sg.targets[e]] = min(apsp[u][sg.targets[e]], metres[e]);
+        }
+        for (int w = 0; w < nodes; ++w) {
+            for (int u = 0; u < nodes; ++u) {
+                for (int v = 0; v < nodes; ++v) apsp[u][v] = min(apsp[u][v], apsp[u][w] + apsp[w][v]);
+            }
+        }
+        node.assign(nodes, 0);
+        arc.assign(m, 0);
+        for (int s = 0; s < smallCenters; ++s) {
+            for (int t = 0; t < smallCenters; ++t) {
+                if (s == t || apsp[s][t] == unreached) continue;
+                shortest.clear();
+                target = apsp[s][t];
+                enumerate(s, t, 0);
+                double share = 0.5 / shortest.size();
+                for (const vector<int>& path : shortest) {
+                    for (size_t i = 0; i < path.size(); ++i) {
+                        arc[path[i]] += share;
+                        if (i > 0) node[sg.targets[path[i - 1]]] += share;
+                    }
                 }
             }
         }
+        computeBetweenness(sg, 0, 1, exact);
+        bool same = true;
+        for (int v = 0; v < nodes; ++v) same = same && fabs(exact.node[v] - node[v]) <= 1e-9 * max(1.0, node[v]);
+        for (int e = 0; e < m; ++e) same = same && fabs(exact.arc[e] - arc[e]) <= 1e-9 * max(1.0, arc[e]);
+        if (!same) ++bruteMismatches;
     }
+    cout << "Mismatches vs brute force on " << smallNetworks << " networks of " << smallCenters
+         << " centers: " << bruteMismatches << "\n";
+}
 
-    cout << "Floyd-Warshall All-Pairs Shortest Paths:\n";
-    for (const auto& hc1 : centers) {
-        for (const auto& hc2 : centers) {
-            if (hc1.id != hc2.id && fwDistances[hc1.id][hc2.id] != INF) {
-                cout << "From " << hc1.id << " to " << hc2.id << ": " << fwDistances[hc1.id][hc2.id] << " km\n";
-            }
-        }
+// Peak resident set size of the process in KiB, or -1 where it is not
+// available. On Linux the high-water mark can be reset between phases.
+long peakRssKb() {
+#ifdef _WIN32
+    return -1;
+#else
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return atol(line.c_str() + 6);
     }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
 }
 
-void primMST(int numCenters) {
-    vector<bool> inMST(MAX, false);
-    vector<float> key(MAX, INF);
-    vector<int> parent(MAX, -1);
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
+void resetPeakRss() {
+#ifdef __linux__
+    ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
 
-    if (centers.empty()) {
-        cout << "No health centers available for MST.\n";
-        return;
-    }
+const string BENCH_RESULTS_FILE = "bench_results.csv";
 
-    int start = centers[0].id;
-    key[start] = 0;
-    pq.push({0, start});
+// Runs each analysis from the menu on a generated network and reports
+// per-call latency percentiles, throughput and the peak RSS reached while it
+// ran. Rows are appended to bench_results.csv so builds can be compared.
+void benchSuite(int n, int queries, NetworkShape shape) {
+    auto genStart = BenchClock::now();
+    generateSyntheticNetwork(n, shape, 42);
+    const CSRGraph& g = graph();
+    cout << NETWORK_SHAPE_NAMES[(int)shape] << " network: " << g.numNodes() << " centers, " << g.numEdges() / 2
+         << " connections (generated in " << fixed << setprecision(1) << elapsedMs(genStart) << " ms)\n";
 
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        pq.pop();
-        if (inMST[u]) continue;
-        inMST[u] = true;
+    bool newFile = !fileExists(BENCH_RESULTS_FILE);
+    ofstream results(BENCH_RESULTS_FILE, ios::app);
+    if (newFile) results << "shape,centers,connections,algorithm,runs,p50_ms,p90_ms,p99_ms,max_ms,ops_per_sec,peak_rss_kb\n";
+    cout << left << setw(18) << "algorithm" << right << setw(7) << "runs" << setw(11) << "p50 ms" << setw(11) << "p90 ms"
+         << setw(11) << "p99 ms" << setw(11) << "max ms" << setw(13) << "ops/s" << setw(13) << "peak RSS" << "\n";
 
-        for (const auto& c : adjList[u]) {
-            if (!inMST[c.to] && c.distance < key[c.to]) {
-                key[c.to] = c.distance;
-                parent[c.to] = u;
-                pq.push({key[c.to], c.to});
-            }
+    auto measure = [&](const string& name, int runs, const function<void(int)>& body) {
+        resetPeakRss();
+        vector<double> samples(runs);
+        for (int r = 0; r < runs; ++r) {
+            auto t0 = BenchClock::now();
+            body(r);
+            samples[r] = elapsedMs(t0);
         }
+        long peak = peakRssKb();
+        double total = 0;
+        for (double ms : samples) total += ms;
+        sort(samples.begin(), samples.end());
+        auto pct = [&](double p) { return samples[min(runs - 1, (int)(p * runs))]; };
+        double opsPerSec = runs / max(1e-9, total / 1000);
+        string rss = peak < 0 ? "n/a" : to_string(peak / 1024) + " MiB";
+        cout << left << setw(18) << name << right << setw(7) << runs << setprecision(4) << setw(11) << pct(0.5)
+             << setw(11) << pct(0.9) << setw(11) << pct(0.99) << setw(11) << samples.back() << setprecision(1)
+             << setw(13) << opsPerSec << setw(13) << rss << "\n";
+        results << NETWORK_SHAPE_NAMES[(int)shape] << "," << g.numNodes() << "," << g.numEdges() / 2 << "," << name
+                << "," << runs << "," << pct(0.5) << "," << pct(0.9) << "," << pct(0.99) << "," << samples.back()
+                << "," << opsPerSec << "," << peak << "\n";
+    };
+
+    mt19937 rng(7);
+    vector<int> sources(queries), targets(queries);
+    for (int q = 0; q < queries; ++q) {
+        sources[q] = rng() % n;
+        targets[q] = rng() % n;
     }
+    vector<float> dist;
+    vector<int> prev, order;
+    QueryContext& qc = queryContext();
+    measure("dijkstra", queries, [&](int q) { dijkstraSearch(g, sources[q], dist, prev); });
+    measure("dijkstra-to", queries, [&](int q) { dijkstraQuery(g, sources[q], targets[q], qc); });
+    measure("bfs", queries, [&](int q) { bfsOrder(g, sources[q], qc, order); });
+    measure("detectCycle", min(queries, 5), [&](int) {
+        connectivity.stale = true; // Time the full rebuild, not the cached answer
+        hasCycle();
+    });
+    measure("primMST", min(queries, 5), [&](int q) { primTree(g, sources[q], qc); });
 
-    cout << "Minimum Spanning Tree Edges:\n";
-    float totalCost = 0;
-    for (int i = 0; i < numCenters; ++i) {
-        if (parent[centers[i].id] != -1) {
-            cout << parent[centers[i].id] << " - " << centers[i].id << ": " << key[centers[i].id] << " km\n";
-            totalCost += key[centers[i].id];
+    const int capacities[] = {100, 250, 400};
+    capacityLayers.clear();
+    measure("emergency-build", 3, [&](int r) { capacityLayer(capacities[r]); });
+    measure("emergencyRouting", queries, [&](int q) {
+        const CapacityLayer& layer = capacityLayer(capacities[q % 3]);
+        order.clear();
+        if (layer.owner[sources[q]] >= 0) {
+            for (int at = sources[q]; at != -1; at = layer.nextHop[at]) order.push_back(at);
         }
+    });
+
+    if (n <= 5000) {
+        measure("floydWarshall", 1, [&](int) { computeAllPairs(); });
+    } else {
+        cout << "floydWarshall skipped above 5000 centers.\n";
     }
-    cout << "Total MST Cost: " << totalCost << " km\n";
+    cout << "Results appended to " << BENCH_RESULTS_FILE << ".\n";
 }
 
-void emergencyRouting(int start, int minCapacity) {
-    vector<float> dist(MAX, INF);
-    vector<int> prev(MAX, -1);
-    dist[start] = 0;
-    priority_queue<pair<float, int>, vector<pair<float, int>>, greater<>> pq;
-    pq.push({0, start});
-
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        float d = pq.top().first;
-        pq.pop();
-        if (d > dist[u]) continue;
-        for (const auto& c : adjList[u]) {
-            if (dist[c.to] > dist[u] + c.distance) {
-                dist[c.to] = dist[u] + c.distance;
-                prev[c.to] = u;
-                pq.push({dist[c.to], c.to});
-            }
-        }
+// Usage: --bench <alt|astar|betweenness|casualty|ch|connectivity|csv|startup|apsp|hops|isochrone|kpaths|labels|local|mst|pareto|queues|spatial|suite> [centers] [queries] [geometric|grid|clustered]
+int runBenchmark(int argc, char* argv[]) {
+    string which = argc > 2 ? argv[2] : "astar";
+    int n = argc > 3 ? atoi(argv[3]) : 100000;
+    int queries = argc > 4 ? atoi(argv[4]) : 200;
+    NetworkShape shape = NetworkShape::Geometric;
+    if (argc > 5 && !parseNetworkShape(argv[5], shape)) {
+        cout << "Unknown network shape: " << argv[5] << "\n";
+        return 1;
     }
-
-    int bestCenter = -1;
-    float minDist = INF;
-    for (const auto& hc : centers) {
-        if (hc.capacity >= minCapacity && dist[hc.id] < minDist) {
-            minDist = dist[hc.id];
-            bestCenter = hc.id;
-        }
+    if (n < 2 || queries < 1) {
+        cout << "Need at least 2 centers and 1 query.\n";
+        return 1;
     }
-
-    if (bestCenter == -1) {
-        cout << "No health center with capacity >= " << minCapacity << " found.\n";
-        return;
+    if (which == "astar") {
+        benchAStar(n, queries, shape);
+        return 0;
     }
-
-    cout << "Nearest health center with capacity >= " << minCapacity << ": ID " << bestCenter << ", Distance: " << minDist << " km\n";
-    cout << "Path: ";
-    vector<int> path;
-    for (int at = bestCenter; at != -1; at = prev[at]) path.push_back(at);
-    for (int i = path.size() - 1; i >= 0; --i) cout << path[i] << (i > 0 ? " -> " : "\n");
+    if (which == "ch") {
+        benchContractionHierarchy(argc > 3 ? n : 20000, queries, shape);
+        return 0;
+    }
+    if (which == "csv") {
+        benchCsvIngestion(n, shape);
+        return 0;
+    }
+    if (which == "startup") {
+        benchStartup(n, shape);
+        return 0;
+    }
+    if (which == "apsp") {
+        benchAllPairs(argc > 3 ? n : 2000, shape);
+        return 0;
+    }
+    if (which == "queues") {
+        benchQueues(n, queries);
+        return 0;
+    }
+    if (which == "hops") {
+        benchHops(n, queries, shape);
+        return 0;
+    }
+    if (which == "connectivity") {
+        benchConnectivity(n, queries, shape);
+        return 0;
+    }
+    if (which == "spatial") {
+        benchSpatial(n, queries, shape);
+        return 0;
+    }
+    if (which == "pareto") {
+        benchPareto(n, queries, shape);
+        return 0;
+    }
+    if (which == "mst") {
+        benchSpanningForest(n, shape);
+        return 0;
+    }
+    if (which == "betweenness") {
+        benchBetweenness(argc > 3 ? n : 5000, shape);
+        return 0;
+    }
+    if (which == "isochrone") {
+        benchIsochrones(argc > 3 ? n : 20000, queries, shape);
+        return 0;
+    }
+    if (which == "alt") {
+        benchLandmarks(n, queries, shape);
+        return 0;
+    }
+    if (which == "labels") {
+        benchHubLabels(argc > 3 ? n : 20000, queries, shape);
+        return 0;
+    }
+    if (which == "local") {
+        benchLocalQueries(n, queries, shape);
+        return 0;
+    }
+    if (which == "kpaths") {
+        benchKShortest(n, queries, shape);
+        return 0;
+    }
+    if (which == "casualty") {
+        benchCasualty(argc > 3 ? n : 5000, argc > 4 ? queries : 10000, shape);
+        return 0;
+    }
+    if (which == "suite") {
+        benchSuite(n, queries, shape);
+        return 0;
+    }
+    cout << "Unknown benchmark: " << which << "\n";
+    return 1;
 }
 
 // Main Menu
-int main() {
-    readHealthCenters("health_centers.csv");
-    readConnections("connections.csv");
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--bench") return runBenchmark(argc, argv);
+
+    if (argc > 1 && string(argv[1]) == "--snapshot") {
+        readHealthCenters("health_centers.csv");
+        readConnections("connections.csv");
+        writeSnapshot("network.snapshot", csvStamp("health_centers.csv", "connections.csv"));
+        cout << "Snapshot written to network.snapshot.\n";
+        return 0;
+    }
+    loadNetwork("health_centers.csv", "connections.csv", "network.snapshot");
+    replayJournals();
+    if (argc > 1 && string(argv[1]) == "--batch") return runBatch(argc, argv);
+    if (argc > 1 && string(argv[1]) == "--build-ch") {
+        currentContractionHierarchy("connections.ch");
+        cout << "Contraction hierarchy saved to connections.ch.\n";
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--build-labels") {
+        currentHubLabels("connections.hl");
+        cout << "Hub labels saved to connections.hl.\n";
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--build-landmarks") {
+        // Usage: --build-landmarks [count] [farthest|district]
+        int count = argc > 2 ? atoi(argv[2]) : DEFAULT_LANDMARKS;
+        LandmarkStrategy strategy = LandmarkStrategy::Farthest;
+        if (count < 1 || (argc > 3 && !parseLandmarkStrategy(argv[3], strategy))) {
+            cout << "Usage: --build-landmarks [count] [farthest|district]\n";
+            return 1;
+        }
+        auto t0 = chrono::steady_clock::now();
+        const LandmarkTable& table = rebuildLandmarks("connections.alt", count, strategy);
+        cout << table.count() << " " << LANDMARK_STRATEGY_NAMES[(int)strategy] << " landmarks saved to connections.alt in "
+             << fixed << setprecision(1) << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count() << " ms.\n";
+        return 0;
+    }
+    openJournal();
 
     int choice;
     while (true) {
@@ -584,19 +6630,38 @@ int main() {
         cout << "8. Remove Connection\n";
         cout << "9. View Relationships\n";
         cout << "10. Dijkstra's Shortest Path\n";
-        cout << "11. BFS Traversal\n1";
+        cout << "11. BFS Traversal\n";
         cout << "12. Detect Cycle\n";
         cout << "13. Floyd-Warshall All-Pairs\n";
         cout << "14. Prim's MST\n";
         cout << "15. Emergency Routing\n";
+        cout << "16. A* Shortest Path\n";
+        cout << "17. Contraction Hierarchy Shortest Path\n";
+        cout << "18. Minimum Spanning Forest\n";
+        cout << "19. Centers Within N Hops\n";
+        cout << "20. Nearest Centers to GPS Point\n";
+        cout << "21. Centers Within Radius of GPS Point\n";
+        cout << "22. Emergency Routing from GPS Point\n";
+        cout << "23. Shortest Path from GPS Point\n";
+        cout << "24. Fastest Route (Minutes)\n";
+        cout << "25. Distance/Time Trade-off Routes\n";
+        cout << "26. Mass-Casualty Assignment\n";
+        cout << "27. Clear Mass-Casualty Incident\n";
+        cout << "28. K Shortest Alternative Routes\n";
+        cout << "29. Distances to Candidate Centers\n";
+        cout << "30. Landmark (ALT) Shortest Path\n";
+        cout << "31. Isochrones (Centers Within Minutes)\n";
+        cout << "32. Coverage Table\n";
+        cout << "33. Betweenness Centrality\n";
         cout << "0. Exit\n";
         cout << "Enter choice: ";
         cin >> choice;
 
         if (choice == 0) break;
 
-        int from, to, time, minCapacity;
-        float dist;
+        CenterId from, to;
+        int time, minCapacity, k;
+        float dist, lat, lon;
         string desc;
         switch (choice) {
             case 1:
@@ -645,7 +6710,7 @@ int main() {
                 detectCycle();
                 break;
             case 13:
-                floydWarshall(centers.size());
+                floydWarshall();
                 break;
             case 14:
                 primMST(centers.size());
@@ -654,9 +6719,97 @@ int main() {
                 cout << "Enter StartID MinCapacity: "; cin >> from >> minCapacity;
                 emergencyRouting(from, minCapacity);
                 break;
+            case 16:
+                cout << "Enter StartID EndID: "; cin >> from >> to;
+                aStar(from, to);
+                break;
+            case 17:
+                cout << "Enter StartID EndID: "; cin >> from >> to;
+                contractionHierarchyRoute(from, to);
+                break;
+            case 18:
+                spanningForest();
+                break;
+            case 19: {
+                cout << "Enter MaxHops then source IDs, ending with -1: "; cin >> time;
+                vector<CenterId> sources;
+                while (cin >> from && from != -1) sources.push_back(from);
+                if (time < 0) cout << "MaxHops must be non-negative.\n";
+                else centersWithinHops(sources, time);
+                break;
+            }
+            case 20:
+                cout << "Enter Latitude Longitude K: "; cin >> lat >> lon >> k;
+                printNearbyCenters(nearestCenters(lat, lon, k));
+                break;
+            case 21:
+                cout << "Enter Latitude Longitude RadiusKM: "; cin >> lat >> lon >> dist;
+                printNearbyCenters(centersWithinRadius(lat, lon, dist));
+                break;
+            case 22:
+                cout << "Enter Latitude Longitude MinCapacity: "; cin >> lat >> lon >> minCapacity;
+                emergencyRoutingFromGps(lat, lon, minCapacity);
+                break;
+            case 23:
+                cout << "Enter Latitude Longitude EndID: "; cin >> lat >> lon >> to;
+                dijkstraFromGps(lat, lon, to);
+                break;
+            case 24:
+                cout << "Enter StartID EndID: "; cin >> from >> to;
+                fastestRoute(from, to);
+                break;
+            case 25:
+                cout << "Enter StartID EndID: "; cin >> from >> to;
+                paretoRouting(from, to);
+                break;
+            case 26: {
+                cout << "Enter SiteID PatientCount pairs, ending with -1: ";
+                vector<pair<CenterId, int>> arrivals;
+                while (cin >> from && from != -1 && cin >> k) arrivals.push_back({from, k});
+                massCasualtyAssignment(arrivals);
+                break;
+            }
+            case 27:
+                clearIncident();
+                break;
+            case 28:
+                cout << "Enter StartID EndID K: "; cin >> from >> to >> k;
+                alternativeRoutes(from, to, k);
+                break;
+            case 29: {
+                cout << "Enter StartID then candidate IDs, ending with -1 (only -1 for all centers): "; cin >> from;
+                vector<CenterId> candidates;
+                while (cin >> to && to != -1) candidates.push_back(to);
+                distancesToCandidates(from, candidates);
+                break;
+            }
+            case 30:
+                cout << "Enter StartID EndID: "; cin >> from >> to;
+                landmarkRoute(from, to);
+                break;
+            case 31: {
+                cout << "Enter StartID then minutes, ending with -1 (only -1 for 30 60 90): "; cin >> from;
+                vector<int> thresholds;
+                while (cin >> time && time != -1) thresholds.push_back(time);
+                isochrones(from, thresholds);
+                break;
+            }
+            case 32: {
+                cout << "Enter minutes, ending with -1 (only -1 for 30 60 90): ";
+                vector<int> thresholds;
+                while (cin >> time && time != -1) thresholds.push_back(time);
+                coverageTable(thresholds, "coverage_table.csv");
+                break;
+            }
+            case 33:
+                cout << "Enter number of sampled sources (0 for exact): "; cin >> k;
+                if (k < 0) cout << "Sample count must be non-negative.\n";
+                else betweennessCentrality(k);
+                break;
             default:
                 cout << "Invalid choice.\n";
         }
     }
+    closeJournal();
     return 0;
 }
\ No newline at end of file